@@ -1,13 +1,19 @@
 -- cat.lua
 -- This script will play the 'walk' animation on the cat entity forever
+-- Written as a module: it is compiled and run once, and every cat shares these functions.
+-- Per-cat state lives on `self`.
 
-function init(entity)
+local Cat = {}
+
+function Cat.init(self, entity)
     PlayAnimation(entity, "walk")
 end
 
-function update(entity, deltaTime)
+function Cat.update(self, entity, deltaTime)
     -- Ensure the animation is always playing
     if not IsAnimationPlaying(entity, "walk") then
         PlayAnimation(entity, "walk")
     end
 end
+
+return Cat
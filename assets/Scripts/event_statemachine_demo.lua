@@ -1,11 +1,29 @@
 -- Event System & State Machine Demo Script
 -- This script demonstrates the advanced event system and state machine framework
 
-local demoTimer = 0.0
 local currentDemo = 1
 local demoDuration = 5.0  -- Switch demos every 5 seconds
 local demos = {"player", "enemy", "events"}
 
+-- Log current state every 2 seconds
+local function logStateLoop(entity)
+    while true do
+        wait(2.0)
+        local currentState = GetCurrentState(entity)
+        if currentState ~= "" then
+            Log("Current state: " .. currentState)
+        end
+    end
+end
+
+-- Sleeps until a demo_event arrives
+local function demoEventLoop(entity)
+    while true do
+        local sender = waitForEvent("demo_event")
+        onEvent(entity, "demo_event", sender)
+    end
+end
+
 function init(entity)
     Log("Event & State Machine Demo script initialized for entity: " .. tostring(entity))
     
@@ -16,14 +34,15 @@ function init(entity)
     -- Add event component for event handling
     AddEventListener(entity, "demo_event")
     Log("Added event listener for demo_event")
+
+    StartCoroutine(entity, logStateLoop, entity)
+    StartCoroutine(entity, demoEventLoop, entity)
 end
 
-function update(entity, deltaTime)
-    demoTimer = demoTimer + deltaTime
-    
-    -- Switch between different demos
-    if demoTimer >= demoDuration then
-        demoTimer = 0.0
+-- Main coroutine: started after init, sleeps between demo switches instead of polling a timer
+function run(entity)
+    while true do
+        wait(demoDuration)
         currentDemo = currentDemo + 1
         if currentDemo > #demos then
             currentDemo = 1
@@ -77,15 +96,9 @@ function update(entity, deltaTime)
             Log("Sent multiple demo events")
         end
     end
-    
-    -- Log current state every 2 seconds
-    if math.floor(demoTimer * 10) % 20 == 0 then
-        local currentState = GetCurrentState(entity)
-        if currentState ~= "" then
-            Log("Current state: " .. currentState)
-        end
-    end
-    
+end
+
+function update(entity, deltaTime)
     -- Handle keyboard input for manual control
     if Input.isKeyDown("q") then
         -- Player states
@@ -0,0 +1,28 @@
+-- Parallel Wander Demo Script
+-- With script workers enabled (Performance tab), `parallel = true` moves this module onto a
+-- worker Lua state. Workers read positions from a snapshot of the frame and their writes are
+-- applied afterwards; other entities are reached through PostMessage/on_message.
+
+local Wander = { parallel = true }
+
+function Wander.init(self, entity)
+    self.time = 0.0
+    self.speed = 30.0 + (entity % 7) * 5.0
+end
+
+function Wander.update(self, entity, deltaTime)
+    self.time = self.time + deltaTime
+    local x, y = GetEntityPosition(entity)
+    if x then
+        SetEntityPosition(entity, x + math.cos(self.time) * self.speed * deltaTime,
+                                  y + math.sin(self.time * 0.7) * self.speed * deltaTime)
+    end
+end
+
+function Wander.on_message(self, entity, name, value, sender)
+    if name == "speed" and type(value) == "number" then
+        self.speed = value
+    end
+end
+
+return Wander
@@ -74,5 +74,11 @@ function update(entity, deltaTime)
         -- Decrease emission rate
         SetParticleEmissionRate(entity, 10.0)
         Log("Decreased emission rate to 10")
+    elseif Input.isKeyDown("9") then
+        -- Pooled one-shot explosion next to this entity; finished effects are reused
+        local x, y = GetEntityPosition(entity)
+        if x then
+            SpawnParticleEffect("explosion", x + 64, y)
+        end
     end
 end
@@ -3,9 +3,9 @@ local jumpForce = 400.0
 
 function init(entity)
     Log("Player script initialized for entity: " .. tostring(entity))
-    local pos = GetEntityPosition(entity)
-    if pos then
-        Log("Player initial position: x=" .. pos[1] .. ", y=" .. pos[2])
+    local x, y = GetEntityPosition(entity)
+    if x then
+        Log("Player initial position: x=" .. x .. ", y=" .. y)
     else
         LogError("Could not get initial position for player entity in Lua.")
     end
@@ -14,10 +14,10 @@ end
 function update(entity, deltaTime)
     local current_vx, current_vy = 0, 0
     if GetEntityVelocity then
-        local vel = GetEntityVelocity(entity)
-        if vel then
-            current_vx = vel[1]
-            current_vy = vel[2]
+        local vx, vy = GetEntityVelocity(entity)
+        if vx then
+            current_vx = vx
+            current_vy = vy
         else
            
         end
@@ -44,9 +44,9 @@ function update(entity, deltaTime)
     local grounded = false
     local contacts = GetCollisionContacts(entity)
     if contacts then
-        for i, contact in ipairs(contacts) do
-           
-            if contact.normalY and contact.normalY < -0.5 then 
+        for i = 1, contacts.count do
+            local other, normalX, normalY = contacts:contact(i)
+            if normalY < -0.5 then 
                 grounded = true
                 new_vy = 0
                 break
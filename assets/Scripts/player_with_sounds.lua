@@ -23,20 +23,20 @@ function update(entityId, deltaTime)
     entity = entityId
     
     -- Get current state
-    local velocity = GetEntityVelocity(entity)
-    if not velocity then
+    local vx, vy = GetEntityVelocity(entity)
+    if not vx then
         LogError("Failed to get velocity for entity: " .. tostring(entity))
         return
     end
     
-    local vx, vy = velocity[1], velocity[2]
     local contacts = GetCollisionContacts(entity)
     local grounded = false
     
     -- Check if grounded (touching something below)
     if contacts then
-        for i, contact in pairs(contacts) do
-            if contact.normalY and contact.normalY < -0.5 then
+        for i = 1, contacts.count do
+            local other, normalX, normalY = contacts:contact(i)
+            if normalY < -0.5 then
                 grounded = true
                 break
             end
@@ -0,0 +1,26 @@
+-- Swarm Batch Demo Script
+-- Attach to many entities: update_batch runs once per frame for all of them,
+-- and positions are read and written in bulk through a reused buffer.
+
+local Swarm = {}
+
+local positions = {}
+local time = 0.0
+local speed = 40.0
+
+function Swarm.init(self, entity)
+    Log("Swarm member joined: " .. tostring(entity))
+end
+
+function Swarm.update_batch(entities, deltaTime)
+    time = time + deltaTime
+    local count = GetPositions(entities, positions)
+    for i = 1, count do
+        local angle = time + i * 0.37
+        positions[2 * i - 1] = positions[2 * i - 1] + math.cos(angle) * speed * deltaTime
+        positions[2 * i] = positions[2 * i] + math.sin(angle) * speed * deltaTime
+    end
+    SetPositions(entities, positions)
+end
+
+return Swarm
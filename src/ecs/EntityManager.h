@@ -22,6 +22,7 @@ public:
 
     void destroyEntity(Entity entity) {
         signatures[entity].reset();
+        ++generations[entity];
         availableEntities.push(entity);
         --livingEntityCount;
         activeEntities.erase(entity);
@@ -35,6 +36,11 @@ public:
         return signatures[entity];
     }
 
+    // Bumped whenever an id is released, so handles that remember it can detect reuse
+    uint32_t getGeneration(Entity entity) const {
+        return generations[entity];
+    }
+
     const std::set<Entity>& getActiveEntities() const {
         return activeEntities;
     }
@@ -42,6 +48,7 @@ public:
     void clear() {
         for (Entity entity : activeEntities) {
             signatures[entity].reset();
+            ++generations[entity];
             availableEntities.push(entity);
         }
         livingEntityCount = 0;
@@ -51,6 +58,7 @@ public:
 private:
     std::queue<Entity> availableEntities;
     std::array<Signature, MAX_ENTITIES> signatures;
+    std::array<uint32_t, MAX_ENTITIES> generations{};
     uint32_t livingEntityCount = 0;
     std::set<Entity> activeEntities;
 };
@@ -38,7 +38,7 @@ public:
     void entityDestroyed(Entity entity) {
         for (auto const& pair : systems) {
             auto const& system = pair.second;
-            system->entities.erase(entity);
+            system->removeEntity(entity);
         }
     }
 
@@ -80,9 +80,9 @@ public:
                 }
 
                 if ((entitySignature & systemSignature) == systemSignature) {
-                    system->entities.insert(entity);
+                    system->addEntity(entity);
                 } else {
-                    system->entities.erase(entity);
+                    system->removeEntity(entity);
                 }
             } else {
                  std::cout << "[SystemManager Debug] Signature NOT FOUND in 'signatures' map for key: '" << systemTypeNameStd << "'" << std::endl;
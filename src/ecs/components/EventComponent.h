@@ -2,10 +2,17 @@
 
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <functional>
 #include <memory>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
 #include "../Entity.h"
+#include "../../events/EventPayload.h"
+#include "../../events/EventRing.h"
 #include "../../../vendor/nlohmann/json.hpp"
 
 // Forward declarations
@@ -26,66 +33,141 @@ enum class EventType {
     SCORE_CHANGED
 };
 
-// Base event data structure
+// Base event data structure. Names and parameter keys are interned ids and parameters live in a
+// fixed inline payload, so creating, copying and queueing events does not touch the heap.
 struct EventData {
     EventType type;
     Entity sender;
     Entity target;
-    std::string eventName;
-    std::unordered_map<std::string, std::string> parameters;
+    EventNameId nameId = NO_EVENT_NAME;
+    EventPayload parameters;
     float timestamp;
+    std::uint64_t sequence = 0; // Assigned by the EventSystem when queued; orders events per sender
     bool consumed = false;
 
     EventData() : type(EventType::CUSTOM_EVENT), sender(NO_ENTITY), target(NO_ENTITY), timestamp(0.0f) {}
     
-    EventData(EventType t, Entity s, Entity tgt = NO_ENTITY, const std::string& name = "") 
-        : type(t), sender(s), target(tgt), eventName(name), timestamp(0.0f) {}
+    EventData(EventType t, Entity s, Entity tgt = NO_ENTITY, std::string_view name = {}) 
+        : type(t), sender(s), target(tgt), nameId(EventNames::intern(name)), timestamp(0.0f) {}
 
-    // Helper methods for parameters
-    void setParameter(const std::string& key, const std::string& value) {
-        parameters[key] = value;
+    EventData(EventType t, Entity s, Entity tgt, EventNameId name)
+        : type(t), sender(s), target(tgt), nameId(name), timestamp(0.0f) {}
+
+    const std::string& eventName() const { return EventNames::name(nameId); }
+
+    // Helper methods for parameters; the EventNameId overloads skip the key lookup
+    void setParameter(EventNameId key, std::string_view value) { report(parameters.setText(key, value), key); }
+    void setParameter(EventNameId key, float value) { report(parameters.setFloat(key, value), key); }
+    void setParameter(EventNameId key, int value) { report(parameters.setInt(key, value), key); }
+    void setParameterEntity(EventNameId key, Entity value) { report(parameters.setEntity(key, value), key); }
+    void setParameterVec2(EventNameId key, float x, float y) { report(parameters.setVec2(key, x, y), key); }
+
+    void setParameter(std::string_view key, std::string_view value) { setParameter(EventNames::intern(key), value); }
+    void setParameter(std::string_view key, float value) { setParameter(EventNames::intern(key), value); }
+    void setParameter(std::string_view key, int value) { setParameter(EventNames::intern(key), value); }
+    void setParameterEntity(std::string_view key, Entity value) { setParameterEntity(EventNames::intern(key), value); }
+    void setParameterVec2(std::string_view key, float x, float y) { setParameterVec2(EventNames::intern(key), x, y); }
+
+    bool hasParameter(std::string_view key) const { return parameters.find(EventNames::find(key)) != nullptr; }
+
+    std::string getParameter(std::string_view key, const std::string& defaultValue = "") const {
+        const EventParam* param = parameters.find(EventNames::find(key));
+        if (!param) return defaultValue;
+        switch (param->type) {
+            case EventParamType::TEXT: return std::string(parameters.text(*param));
+            case EventParamType::INT: return std::to_string(param->i);
+            case EventParamType::FLOAT: return std::to_string(param->f);
+            case EventParamType::ENTITY: return std::to_string(param->entity);
+            case EventParamType::VEC2: return std::to_string(param->vec2.x) + "," + std::to_string(param->vec2.y);
+            default: return defaultValue;
+        }
     }
 
-    void setParameter(const std::string& key, float value) {
-        parameters[key] = std::to_string(value);
+    float getParameterFloat(EventNameId key, float defaultValue = 0.0f) const {
+        const EventParam* param = parameters.find(key);
+        if (!param) return defaultValue;
+        switch (param->type) {
+            case EventParamType::FLOAT: return param->f;
+            case EventParamType::INT: return static_cast<float>(param->i);
+            case EventParamType::ENTITY: return static_cast<float>(param->entity);
+            case EventParamType::TEXT: {
+                std::string text(parameters.text(*param));
+                char* end = nullptr;
+                float value = std::strtof(text.c_str(), &end);
+                return end != text.c_str() ? value : defaultValue;
+            }
+            default: return defaultValue;
+        }
     }
 
-    void setParameter(const std::string& key, int value) {
-        parameters[key] = std::to_string(value);
+    int getParameterInt(EventNameId key, int defaultValue = 0) const {
+        const EventParam* param = parameters.find(key);
+        if (!param) return defaultValue;
+        switch (param->type) {
+            case EventParamType::INT: return param->i;
+            case EventParamType::FLOAT: return static_cast<int>(param->f);
+            case EventParamType::ENTITY: return static_cast<int>(param->entity);
+            case EventParamType::TEXT: {
+                std::string text(parameters.text(*param));
+                char* end = nullptr;
+                long value = std::strtol(text.c_str(), &end, 10);
+                return end != text.c_str() ? static_cast<int>(value) : defaultValue;
+            }
+            default: return defaultValue;
+        }
     }
 
-    std::string getParameter(const std::string& key, const std::string& defaultValue = "") const {
-        auto it = parameters.find(key);
-        return (it != parameters.end()) ? it->second : defaultValue;
+    Entity getParameterEntity(EventNameId key, Entity defaultValue = NO_ENTITY) const {
+        const EventParam* param = parameters.find(key);
+        if (!param) return defaultValue;
+        if (param->type == EventParamType::ENTITY) return param->entity;
+        if (param->type == EventParamType::INT && param->i >= 0) return static_cast<Entity>(param->i);
+        return defaultValue;
     }
 
-    float getParameterFloat(const std::string& key, float defaultValue = 0.0f) const {
-        auto it = parameters.find(key);
-        return (it != parameters.end()) ? std::stof(it->second) : defaultValue;
+    EventVec2 getParameterVec2(EventNameId key, EventVec2 defaultValue = {0.0f, 0.0f}) const {
+        const EventParam* param = parameters.find(key);
+        return (param && param->type == EventParamType::VEC2) ? param->vec2 : defaultValue;
     }
 
-    int getParameterInt(const std::string& key, int defaultValue = 0) const {
-        auto it = parameters.find(key);
-        return (it != parameters.end()) ? std::stoi(it->second) : defaultValue;
+    float getParameterFloat(std::string_view key, float defaultValue = 0.0f) const { return getParameterFloat(EventNames::find(key), defaultValue); }
+    int getParameterInt(std::string_view key, int defaultValue = 0) const { return getParameterInt(EventNames::find(key), defaultValue); }
+    Entity getParameterEntity(std::string_view key, Entity defaultValue = NO_ENTITY) const { return getParameterEntity(EventNames::find(key), defaultValue); }
+    EventVec2 getParameterVec2(std::string_view key, EventVec2 defaultValue = {0.0f, 0.0f}) const { return getParameterVec2(EventNames::find(key), defaultValue); }
+
+private:
+    void report(bool stored, EventNameId key) const {
+        if (!stored) {
+            std::cerr << "[EventSystem] Parameter '" << EventNames::name(key) << "' dropped or truncated on event '"
+                      << eventName() << "' (payload holds " << EventPayload::MAX_PARAMS << " parameters)" << std::endl;
+        }
     }
 };
 
+// Source of EventComponent::listenerRevision values; unique across components so a recycled
+// entity never looks unchanged to the EventSystem's subscription index
+inline std::uint32_t nextEventListenerRevision() {
+    static std::atomic<std::uint32_t> revision{0};
+    return ++revision;
+}
+
 // Event listener function type
 using EventListener = std::function<void(const EventData&)>;
 
 // Event listener registration
 struct EventListenerRegistration {
     EventType eventType;
-    std::string eventName;
+    EventNameId nameId = NO_EVENT_NAME;
     EventListener callback;
     int priority = 0; // Higher priority listeners are called first
     bool oneShot = false; // If true, listener is removed after first call
+    std::uint32_t id = 0; // Unique within the owning component, assigned on registration
 
     EventListenerRegistration(EventType type, EventListener cb, int prio = 0, bool once = false)
         : eventType(type), callback(cb), priority(prio), oneShot(once) {}
 
     EventListenerRegistration(const std::string& name, EventListener cb, int prio = 0, bool once = false)
-        : eventType(EventType::CUSTOM_EVENT), eventName(name), callback(cb), priority(prio), oneShot(once) {}
+        : eventType(EventType::CUSTOM_EVENT), nameId(EventNames::intern(name)), callback(cb), priority(prio), oneShot(once) {}
 };
 
 // Component for entities that can send and receive events
@@ -93,11 +175,14 @@ struct EventComponent {
     // Outgoing events queue (events this entity wants to send)
     std::vector<EventData> outgoingEvents;
     
-    // Event listeners (events this entity wants to receive)
+    // Event listeners (events this entity wants to receive). Changes bump listenerRevision,
+    // which tells the EventSystem to re-index this entity's subscriptions.
     std::vector<EventListenerRegistration> listeners;
+    std::uint32_t listenerRevision = 0;
+    std::uint32_t nextListenerId = 1;
     
-    // Event history for debugging
-    std::vector<EventData> eventHistory;
+    // Recent events sent by this entity, oldest first (read by event-triggered state transitions)
+    HistoryRing<EventData> eventHistory;
     int maxHistorySize = 50;
     
     // Performance tracking
@@ -112,35 +197,58 @@ struct EventComponent {
         eventsSentThisFrame++;
     }
 
+    void sendEvent(EventData&& event) {
+        outgoingEvents.push_back(std::move(event));
+        eventsSentThisFrame++;
+    }
+
     void sendEvent(EventType type, Entity target = NO_ENTITY, const std::string& name = "") {
-        EventData event(type, NO_ENTITY, target, name); // sender will be set by EventSystem
-        sendEvent(event);
+        sendEvent(EventData(type, NO_ENTITY, target, name)); // sender will be set by EventSystem
     }
 
     void sendCustomEvent(const std::string& eventName, Entity target = NO_ENTITY) {
-        EventData event(EventType::CUSTOM_EVENT, NO_ENTITY, target, eventName);
-        sendEvent(event);
+        sendEvent(EventData(EventType::CUSTOM_EVENT, NO_ENTITY, target, eventName));
     }
 
     // Register event listener
     void addEventListener(EventType type, EventListener callback, int priority = 0, bool oneShot = false) {
-        listeners.emplace_back(type, callback, priority, oneShot);
-        // Sort by priority (higher first)
-        std::sort(listeners.begin(), listeners.end(), 
-            [](const EventListenerRegistration& a, const EventListenerRegistration& b) {
-                return a.priority > b.priority;
-            });
+        insertListener(EventListenerRegistration(type, std::move(callback), priority, oneShot));
     }
 
     void addEventListener(const std::string& eventName, EventListener callback, int priority = 0, bool oneShot = false) {
-        listeners.emplace_back(eventName, callback, priority, oneShot);
-        // Sort by priority (higher first)
-        std::sort(listeners.begin(), listeners.end(), 
-            [](const EventListenerRegistration& a, const EventListenerRegistration& b) {
-                return a.priority > b.priority;
+        insertListener(EventListenerRegistration(eventName, std::move(callback), priority, oneShot));
+    }
+
+    void insertListener(EventListenerRegistration registration) {
+        registration.id = nextListenerId++;
+        // Keep sorted by priority (higher first), registration order within a priority
+        auto position = std::upper_bound(listeners.begin(), listeners.end(), registration.priority,
+            [](int priority, const EventListenerRegistration& reg) {
+                return priority > reg.priority;
             });
+        listeners.insert(position, std::move(registration));
+        touchListeners();
     }
 
+    EventListenerRegistration* findListener(std::uint32_t listenerId) {
+        for (auto& listener : listeners) {
+            if (listener.id == listenerId) return &listener;
+        }
+        return nullptr;
+    }
+
+    void removeListenerById(std::uint32_t listenerId) {
+        for (auto it = listeners.begin(); it != listeners.end(); ++it) {
+            if (it->id == listenerId) {
+                listeners.erase(it);
+                touchListeners();
+                return;
+            }
+        }
+    }
+
+    void touchListeners() { listenerRevision = nextEventListenerRevision(); }
+
     // Remove event listeners
     void removeEventListener(EventType type) {
         listeners.erase(
@@ -149,15 +257,18 @@ struct EventComponent {
                     return reg.eventType == type;
                 }),
             listeners.end());
+        touchListeners();
     }
 
     void removeEventListener(const std::string& eventName) {
+        EventNameId nameId = EventNames::find(eventName);
         listeners.erase(
             std::remove_if(listeners.begin(), listeners.end(),
-                [&eventName](const EventListenerRegistration& reg) {
-                    return reg.eventName == eventName;
+                [nameId](const EventListenerRegistration& reg) {
+                    return reg.nameId == nameId;
                 }),
             listeners.end());
+        touchListeners();
     }
 
     // Clear all events and reset counters
@@ -169,10 +280,8 @@ struct EventComponent {
 
     // Add event to history
     void addToHistory(const EventData& event) {
-        eventHistory.push_back(event);
-        if (eventHistory.size() > maxHistorySize) {
-            eventHistory.erase(eventHistory.begin());
-        }
+        eventHistory.setCapacity(static_cast<size_t>(std::max(0, maxHistorySize)));
+        eventHistory.push(event);
     }
 };
 
@@ -187,6 +296,7 @@ inline void to_json(nlohmann::json& j, const EventComponent& comp) {
 inline void from_json(const nlohmann::json& j, EventComponent& comp) {
     comp.maxHistorySize = j.value("maxHistorySize", 50);
     comp.listeners.clear();
+    comp.touchListeners();
     comp.outgoingEvents.clear();
     comp.eventHistory.clear();
 }
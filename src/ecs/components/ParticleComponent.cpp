@@ -1,6 +1,8 @@
 #include "ParticleComponent.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <functional>
 
 // Helper function to interpolate between two colors
 SDL_Color lerpColor(const SDL_Color& a, const SDL_Color& b, float t) {
@@ -69,6 +71,72 @@ float ParticleEmitterComponent::interpolateSize(float t) const {
     return sizeCurve.back().size;
 }
 
+float ParticleEmitterComponent::interpolateVelocity(float t) const {
+    t = std::clamp(t, 0.0f, 1.0f);
+    
+    // If no velocity curve, speed is unchanged
+    if (velocityCurve.empty()) {
+        return 1.0f;
+    }
+    
+    if (velocityCurve.size() == 1) {
+        return velocityCurve[0].multiplier;
+    }
+    
+    // Find the segment
+    for (size_t i = 0; i < velocityCurve.size() - 1; ++i) {
+        if (t >= velocityCurve[i].time && t <= velocityCurve[i + 1].time) {
+            float segmentT = (t - velocityCurve[i].time) / (velocityCurve[i + 1].time - velocityCurve[i].time);
+            return lerpFloat(velocityCurve[i].multiplier, velocityCurve[i + 1].multiplier, segmentT);
+        }
+    }
+    
+    return velocityCurve.back().multiplier;
+}
+
+namespace {
+    template <typename T>
+    void hashCombine(size_t& seed, const T& value) {
+        seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+}
+
+void ParticleEmitterComponent::updateCurveLUTs() {
+    // Cheap signature of every curve input; the tables are only rebuilt when it changes
+    size_t hash = 0;
+    auto hashColor = [&hash](const SDL_Color& c) {
+        hashCombine(hash, (static_cast<uint32_t>(c.r) << 24) | (c.g << 16) | (c.b << 8) | c.a);
+    };
+    hashColor(startColor);
+    hashColor(endColor);
+    hashCombine(hash, colorCurve.size());
+    for (const auto& point : colorCurve) {
+        hashCombine(hash, point.time);
+        hashColor(point.color);
+    }
+    hashCombine(hash, sizeCurve.size());
+    for (const auto& point : sizeCurve) {
+        hashCombine(hash, point.time);
+        hashCombine(hash, point.size);
+    }
+    hashCombine(hash, velocityCurve.size());
+    for (const auto& point : velocityCurve) {
+        hashCombine(hash, point.time);
+        hashCombine(hash, point.multiplier);
+    }
+
+    if (curveLUTsBuilt && hash == curveHash) return;
+
+    for (int i = 0; i < PARTICLE_CURVE_LUT_SIZE; ++i) {
+        float t = static_cast<float>(i) / (PARTICLE_CURVE_LUT_SIZE - 1);
+        colorLUT[i] = interpolateColor(t);
+        sizeLUT[i] = interpolateSize(t);
+        velocityLUT[i] = interpolateVelocity(t);
+    }
+    curveHash = hash;
+    curveLUTsBuilt = true;
+}
+
 void ParticleEmitterComponent::resetEmission() {
     emissionTimer = 0.0f;
     emissionTime = 0.0f;
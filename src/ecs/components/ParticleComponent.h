@@ -1,28 +1,13 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <cstdint>
 #include <SDL2/SDL.h>
 #include "../../../vendor/nlohmann/json.hpp"
 
-// Individual particle data
-struct Particle {
-    float x, y;                    // Position
-    float vx, vy;                  // Velocity
-    float ax, ay;                  // Acceleration
-    float life;                    // Current life (0.0 to maxLife)
-    float maxLife;                 // Maximum lifetime
-    float size;                    // Current size
-    float rotation;                // Current rotation
-    float rotationSpeed;           // Rotation speed
-    SDL_Color color;               // Current color
-    bool active;                   // Is particle active
-    
-    Particle() : x(0), y(0), vx(0), vy(0), ax(0), ay(0), 
-                 life(0), maxLife(1.0f), size(1.0f), rotation(0), rotationSpeed(0),
-                 color{255, 255, 255, 255}, active(false) {}
-};
-
 // Emission shapes
 enum class EmissionShape {
     POINT,
@@ -38,6 +23,14 @@ enum class ParticleBlendMode {
     MULTIPLY
 };
 
+// Response when a particle enters static collision geometry
+enum class ParticleCollisionMode {
+    NONE,
+    BOUNCE,
+    DIE,
+    STICK
+};
+
 // Color curve point for animating color over lifetime
 struct ColorCurvePoint {
     float time;        // 0.0 to 1.0 (lifetime percentage)
@@ -55,6 +48,17 @@ struct SizeCurvePoint {
     SizeCurvePoint(float t = 0.0f, float s = 1.0f) : time(t), size(s) {}
 };
 
+// Speed multiplier point for scaling velocity over lifetime
+struct VelocityCurvePoint {
+    float time;        // 0.0 to 1.0 (lifetime percentage)
+    float multiplier;
+    
+    VelocityCurvePoint(float t = 0.0f, float m = 1.0f) : time(t), multiplier(m) {}
+};
+
+// Number of samples each lifetime curve is baked into
+constexpr int PARTICLE_CURVE_LUT_SIZE = 256;
+
 // Particle emitter configuration
 struct ParticleEmitterComponent {
     // Basic emission properties
@@ -65,6 +69,8 @@ struct ParticleEmitterComponent {
     bool looping = true;               // Should the emitter loop
     float duration = 5.0f;             // Duration before stopping (if not looping)
     float emissionTime = 0.0f;         // Time since emission started
+    int priority = 0;                  // Higher keeps emitting first when the particle budget runs out
+    bool prewarm = false;              // Looping emitters start at steady state instead of empty
     
     // Particle lifetime
     float minLifetime = 1.0f;
@@ -87,6 +93,11 @@ struct ParticleEmitterComponent {
     float gravityY = 98.0f;            // Default gravity
     float damping = 0.98f;             // Velocity damping (0.0 to 1.0)
     
+    // World collision (static colliders only)
+    ParticleCollisionMode collisionMode = ParticleCollisionMode::NONE;
+    float bounciness = 0.5f;           // Fraction of the velocity kept along the hit axis
+    float collisionFriction = 0.1f;    // Fraction of the other velocity component lost per bounce
+    
     // Visual properties
     std::string textureId = "";        // Texture for particles
     ParticleBlendMode blendMode = ParticleBlendMode::ALPHA;
@@ -101,6 +112,9 @@ struct ParticleEmitterComponent {
     SDL_Color endColor = {255, 255, 255, 0};
     std::vector<ColorCurvePoint> colorCurve;
     
+    // Velocity over lifetime (empty = constant speed)
+    std::vector<VelocityCurvePoint> velocityCurve;
+    
     // Rotation
     float minStartRotation = 0.0f;
     float maxStartRotation = 0.0f;
@@ -117,17 +131,70 @@ struct ParticleEmitterComponent {
         colorCurve.push_back(ColorCurvePoint(1.0f, {255, 255, 255, 0}));
     }
     
+    // Curves baked into lookup tables, rebuilt by updateCurveLUTs() when any curve input changes (not serialized)
+    std::array<SDL_Color, PARTICLE_CURVE_LUT_SIZE> colorLUT;
+    std::array<float, PARTICLE_CURVE_LUT_SIZE> sizeLUT;
+    std::array<float, PARTICLE_CURVE_LUT_SIZE> velocityLUT;
+    size_t curveHash = 0;
+    bool curveLUTsBuilt = false;
+    
     // Helper methods
     SDL_Color interpolateColor(float t) const;
     float interpolateSize(float t) const;
+    float interpolateVelocity(float t) const;
     void resetEmission();
+    
+    void updateCurveLUTs();
+    bool hasVelocityCurve() const { return !velocityCurve.empty(); }
+    // Table index for a normalized lifetime, rounded to the nearest sample
+    static int curveLUTIndex(float t) {
+        int index = static_cast<int>(t * (PARTICLE_CURVE_LUT_SIZE - 1) + 0.5f);
+        return std::clamp(index, 0, PARTICLE_CURVE_LUT_SIZE - 1);
+    }
+};
+
+// Per-emitter xorshift32 generator, cheap enough to call several times per spawned particle
+struct ParticleRandom {
+    uint32_t state = 0x9E3779B9u;
+    
+    void seed(uint32_t value) { state = value ? value : 0x9E3779B9u; }
+    
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    
+    // Uniform in [0, 1) from the top 24 bits
+    float next01() { return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f); }
+    float range(float min, float max) { return min + next01() * (max - min); }
 };
 
-// Component that holds the actual particles
+// Component that holds the actual particles, one array per attribute. Live particles are
+// packed in [0, activeParticleCount); dead ones are swap-removed, so update and render loops
+// walk dense arrays without testing an active flag.
 struct ParticleComponent {
-    std::vector<Particle> particles;
+    std::vector<float> x, y;               // Position
+    std::vector<float> vx, vy;             // Velocity
+    std::vector<float> life;               // Current life (0.0 to maxLife)
+    std::vector<float> maxLife;            // Maximum lifetime
+    std::vector<float> size;               // Current size
+    std::vector<float> rotation;           // Current rotation
+    std::vector<float> rotationSpeed;      // Rotation speed
+    std::vector<SDL_Color> color;          // Current color
     int activeParticleCount = 0;
     
+    // Emission randomness, seeded by the ParticleSystem (not serialized)
+    ParticleRandom random;
+    unsigned int randomSeedEpoch = 0;
+    
+    // Off-screen time not yet simulated (particle LOD)
+    float skippedTime = 0.0f;
+    
+    bool prewarmed = false;                // Emitter prewarm already applied
+    bool pooled = false;                   // Owned by the ParticleSystem effect pool
+    
     // Performance tracking
     float lastUpdateTime = 0.0f;
     int particlesEmittedThisFrame = 0;
@@ -135,26 +202,38 @@ struct ParticleComponent {
     ParticleComponent() = default;
     
     void reserveParticles(int count) {
-        particles.reserve(count);
-        particles.resize(count);
+        count = std::max(0, count);
+        for (auto* attribute : {&x, &y, &vx, &vy, &life, &maxLife, &size, &rotation, &rotationSpeed}) {
+            attribute->resize(count, 0.0f);
+        }
+        color.resize(count, SDL_Color{255, 255, 255, 255});
+        activeParticleCount = std::min(activeParticleCount, count);
     }
     
-    Particle* getInactiveParticle() {
-        for (auto& particle : particles) {
-            if (!particle.active) {
-                return &particle;
-            }
-        }
-        return nullptr;
+    int capacity() const { return static_cast<int>(x.size()); }
+    
+    // Claims up to count slots right after the live range, starting at the previous
+    // activeParticleCount; returns how many were claimed
+    int spawnParticles(int count) {
+        count = std::clamp(count, 0, capacity() - activeParticleCount);
+        activeParticleCount += count;
+        return count;
     }
     
-    void updateActiveCount() {
-        activeParticleCount = 0;
-        for (const auto& particle : particles) {
-            if (particle.active) {
-                activeParticleCount++;
-            }
-        }
+    // Moves the last live particle into the freed slot, so the caller must revisit the same index
+    void killParticle(int index) {
+        int last = --activeParticleCount;
+        if (index == last) return;
+        x[index] = x[last];
+        y[index] = y[last];
+        vx[index] = vx[last];
+        vy[index] = vy[last];
+        life[index] = life[last];
+        maxLife[index] = maxLife[last];
+        size[index] = size[last];
+        rotation[index] = rotation[last];
+        rotationSpeed[index] = rotationSpeed[last];
+        color[index] = color[last];
     }
 };
 
@@ -166,6 +245,8 @@ inline void to_json(nlohmann::json& j, const ParticleEmitterComponent& comp) {
         {"maxParticles", comp.maxParticles},
         {"looping", comp.looping},
         {"duration", comp.duration},
+        {"priority", comp.priority},
+        {"prewarm", comp.prewarm},
         {"minLifetime", comp.minLifetime},
         {"maxLifetime", comp.maxLifetime},
         {"shape", static_cast<int>(comp.shape)},
@@ -179,6 +260,9 @@ inline void to_json(nlohmann::json& j, const ParticleEmitterComponent& comp) {
         {"gravityX", comp.gravityX},
         {"gravityY", comp.gravityY},
         {"damping", comp.damping},
+        {"collisionMode", static_cast<int>(comp.collisionMode)},
+        {"bounciness", comp.bounciness},
+        {"collisionFriction", comp.collisionFriction},
         {"textureId", comp.textureId},
         {"blendMode", static_cast<int>(comp.blendMode)},
         {"minStartSize", comp.minStartSize},
@@ -190,6 +274,24 @@ inline void to_json(nlohmann::json& j, const ParticleEmitterComponent& comp) {
         {"minRotationSpeed", comp.minRotationSpeed},
         {"maxRotationSpeed", comp.maxRotationSpeed}
     };
+
+    nlohmann::json colorCurveJson = nlohmann::json::array();
+    for (const auto& point : comp.colorCurve) {
+        colorCurveJson.push_back({{"time", point.time}, {"color", {point.color.r, point.color.g, point.color.b, point.color.a}}});
+    }
+    j["colorCurve"] = colorCurveJson;
+
+    nlohmann::json sizeCurveJson = nlohmann::json::array();
+    for (const auto& point : comp.sizeCurve) {
+        sizeCurveJson.push_back({{"time", point.time}, {"size", point.size}});
+    }
+    j["sizeCurve"] = sizeCurveJson;
+
+    nlohmann::json velocityCurveJson = nlohmann::json::array();
+    for (const auto& point : comp.velocityCurve) {
+        velocityCurveJson.push_back({{"time", point.time}, {"multiplier", point.multiplier}});
+    }
+    j["velocityCurve"] = velocityCurveJson;
 }
 
 inline void from_json(const nlohmann::json& j, ParticleEmitterComponent& comp) {
@@ -198,6 +300,8 @@ inline void from_json(const nlohmann::json& j, ParticleEmitterComponent& comp) {
     comp.maxParticles = j.value("maxParticles", 100);
     comp.looping = j.value("looping", true);
     comp.duration = j.value("duration", 5.0f);
+    comp.priority = j.value("priority", 0);
+    comp.prewarm = j.value("prewarm", false);
     comp.minLifetime = j.value("minLifetime", 1.0f);
     comp.maxLifetime = j.value("maxLifetime", 3.0f);
     comp.shape = static_cast<EmissionShape>(j.value("shape", 0));
@@ -211,6 +315,9 @@ inline void from_json(const nlohmann::json& j, ParticleEmitterComponent& comp) {
     comp.gravityX = j.value("gravityX", 0.0f);
     comp.gravityY = j.value("gravityY", 98.0f);
     comp.damping = j.value("damping", 0.98f);
+    comp.collisionMode = static_cast<ParticleCollisionMode>(j.value("collisionMode", 0));
+    comp.bounciness = j.value("bounciness", 0.5f);
+    comp.collisionFriction = j.value("collisionFriction", 0.1f);
     comp.textureId = j.value("textureId", "");
     comp.blendMode = static_cast<ParticleBlendMode>(j.value("blendMode", 0));
     comp.minStartSize = j.value("minStartSize", 1.0f);
@@ -229,4 +336,25 @@ inline void from_json(const nlohmann::json& j, ParticleEmitterComponent& comp) {
     comp.maxStartRotation = j.value("maxStartRotation", 0.0f);
     comp.minRotationSpeed = j.value("minRotationSpeed", 0.0f);
     comp.maxRotationSpeed = j.value("maxRotationSpeed", 0.0f);
+
+    // Curves are optional; older scenes keep the constructor defaults
+    if (j.contains("colorCurve") && j["colorCurve"].is_array()) {
+        comp.colorCurve.clear();
+        for (const auto& point : j["colorCurve"]) {
+            auto c = point.value("color", nlohmann::json::array({255, 255, 255, 255}));
+            comp.colorCurve.push_back(ColorCurvePoint(point.value("time", 0.0f), {c[0], c[1], c[2], c[3]}));
+        }
+    }
+    if (j.contains("sizeCurve") && j["sizeCurve"].is_array()) {
+        comp.sizeCurve.clear();
+        for (const auto& point : j["sizeCurve"]) {
+            comp.sizeCurve.push_back(SizeCurvePoint(point.value("time", 0.0f), point.value("size", 1.0f)));
+        }
+    }
+    if (j.contains("velocityCurve") && j["velocityCurve"].is_array()) {
+        comp.velocityCurve.clear();
+        for (const auto& point : j["velocityCurve"]) {
+            comp.velocityCurve.push_back(VelocityCurvePoint(point.value("time", 0.0f), point.value("multiplier", 1.0f)));
+        }
+    }
 }
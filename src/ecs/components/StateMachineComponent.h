@@ -29,6 +29,7 @@ struct StateTransition {
     
     // Condition parameters
     std::string eventName;
+    EventNameId eventNameId = NO_EVENT_NAME;   // eventName interned when the transition is added or loaded
     EventType eventType = EventType::CUSTOM_EVENT;
     float timerDuration = 0.0f;
     std::string parameterName;
@@ -138,6 +139,7 @@ struct StateMachineComponent {
     // Transition management
     void addTransition(const StateTransition& transition) {
         transitions.push_back(transition);
+        transitions.back().eventNameId = EventNames::intern(transition.eventName);
         // Sort by priority (higher first)
         std::sort(transitions.begin(), transitions.end(),
             [](const StateTransition& a, const StateTransition& b) {
@@ -298,6 +300,7 @@ inline void from_json(const nlohmann::json& j, StateMachineComponent& comp) {
             transition.toState = transitionJson.value("toState", "");
             transition.condition = static_cast<TransitionCondition>(transitionJson.value("condition", 0));
             transition.eventName = transitionJson.value("eventName", "");
+            transition.eventNameId = EventNames::intern(transition.eventName);
             transition.eventType = static_cast<EventType>(transitionJson.value("eventType", 0));
             transition.timerDuration = transitionJson.value("timerDuration", 0.0f);
             transition.parameterName = transitionJson.value("parameterName", "");
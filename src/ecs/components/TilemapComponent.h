@@ -0,0 +1,201 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include "../../../vendor/nlohmann/json.hpp"
+
+// Tiles per chunk edge. Each chunk is baked into a single texture by the TilemapSystem.
+const int TILEMAP_CHUNK_SIZE = 16;
+const std::int16_t TILE_EMPTY = -1;
+const int TILE_MAX_ID = INT16_MAX;    // Tiles are stored as int16
+
+// Dense block of tiles; revision is bumped on every edit so cached textures know when to re-bake
+struct TilemapChunk {
+    std::array<std::int16_t, TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE> tiles;
+    std::uint32_t revision = 0;
+    int filledTiles = 0;
+
+    TilemapChunk() { tiles.fill(TILE_EMPTY); }
+};
+
+// Merged solid area in tilemap-local pixel space
+struct TileCollisionRect {
+    float x, y, w, h;
+};
+
+struct TilemapComponent {
+    // Tileset
+    std::string tilesetTextureId = "";
+    int tileWidth = 32;
+    int tileHeight = 32;
+    int tilesetColumns = 1;            // Tiles per row in the tileset texture
+
+    // Map dimensions in tiles
+    int width = 0;
+    int height = 0;
+    int chunksX = 0;
+    int chunksY = 0;
+    std::vector<TilemapChunk> chunks;  // Row-major, chunksX * chunksY
+
+    // Collision
+    bool generateCollision = true;
+    bool allTilesSolid = true;         // If false, only solidTileIds collide
+    std::vector<int> solidTileIds;
+
+    // Runtime state (not serialized)
+    std::uint32_t layoutRevision = 0;  // Bumped when tile size, tileset or dimensions change
+    bool collisionDirty = true;
+    std::vector<TileCollisionRect> collisionRects;
+
+    TilemapComponent() = default;
+    TilemapComponent(const std::string& tileset, int tileW, int tileH, int columns, int mapW, int mapH)
+        : tilesetTextureId(tileset), tileWidth(tileW), tileHeight(tileH), tilesetColumns(columns) {
+        resize(mapW, mapH);
+    }
+
+    void resize(int newWidth, int newHeight) {
+        newWidth = std::max(0, newWidth);
+        newHeight = std::max(0, newHeight);
+        int newChunksX = (newWidth + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+        int newChunksY = (newHeight + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+
+        std::vector<TilemapChunk> newChunks(static_cast<size_t>(newChunksX) * newChunksY);
+        std::swap(chunks, newChunks);
+        int oldWidth = width;
+        int oldHeight = height;
+        int oldChunksX = chunksX;
+        width = newWidth;
+        height = newHeight;
+        chunksX = newChunksX;
+        chunksY = newChunksY;
+
+        // Copy surviving tiles from the old layout
+        for (int ty = 0; ty < std::min(oldHeight, newHeight); ++ty) {
+            for (int tx = 0; tx < std::min(oldWidth, newWidth); ++tx) {
+                const TilemapChunk& oldChunk = newChunks[(ty / TILEMAP_CHUNK_SIZE) * oldChunksX + (tx / TILEMAP_CHUNK_SIZE)];
+                std::int16_t id = oldChunk.tiles[localIndex(tx, ty)];
+                if (id != TILE_EMPTY) {
+                    setTile(tx, ty, id);
+                }
+            }
+        }
+
+        layoutRevision++;
+        collisionDirty = true;
+    }
+
+    bool inBounds(int tx, int ty) const {
+        return tx >= 0 && ty >= 0 && tx < width && ty < height;
+    }
+
+    int getTile(int tx, int ty) const {
+        if (!inBounds(tx, ty)) return TILE_EMPTY;
+        return chunkAt(tx, ty).tiles[localIndex(tx, ty)];
+    }
+
+    // Negative ids clear the tile; returns false (and changes nothing) for positions outside the
+    // map and for ids that do not fit in a tile
+    bool setTile(int tx, int ty, int id) {
+        if (!inBounds(tx, ty) || id > TILE_MAX_ID) return false;
+        TilemapChunk& chunk = chunks[chunkIndex(tx, ty)];
+        std::int16_t& tile = chunk.tiles[localIndex(tx, ty)];
+        std::int16_t newId = static_cast<std::int16_t>(id < 0 ? TILE_EMPTY : id);
+        if (tile == newId) return true;
+
+        if (tile == TILE_EMPTY) chunk.filledTiles++;
+        if (newId == TILE_EMPTY) chunk.filledTiles--;
+        tile = newId;
+        chunk.revision++;
+        collisionDirty = true;
+        return true;
+    }
+
+    void fill(int id) {
+        for (int ty = 0; ty < height; ++ty) {
+            for (int tx = 0; tx < width; ++tx) {
+                setTile(tx, ty, id);
+            }
+        }
+    }
+
+    bool isSolid(int id) const {
+        if (id == TILE_EMPTY) return false;
+        if (allTilesSolid) return true;
+        return std::find(solidTileIds.begin(), solidTileIds.end(), id) != solidTileIds.end();
+    }
+
+    // Source rect of a tile id inside the tileset texture
+    void getTileSourceRect(int id, int& sx, int& sy) const {
+        int columns = std::max(1, tilesetColumns);
+        sx = (id % columns) * tileWidth;
+        sy = (id / columns) * tileHeight;
+    }
+
+    // Call after changing tileset or tile size so cached chunk textures are rebuilt
+    void markLayoutChanged() {
+        layoutRevision++;
+        collisionDirty = true;
+    }
+
+    int chunkIndex(int tx, int ty) const {
+        return (ty / TILEMAP_CHUNK_SIZE) * chunksX + (tx / TILEMAP_CHUNK_SIZE);
+    }
+
+    static int localIndex(int tx, int ty) {
+        return (ty % TILEMAP_CHUNK_SIZE) * TILEMAP_CHUNK_SIZE + (tx % TILEMAP_CHUNK_SIZE);
+    }
+
+private:
+    const TilemapChunk& chunkAt(int tx, int ty) const {
+        return chunks[chunkIndex(tx, ty)];
+    }
+};
+
+// Tiles are stored row-major as a flat array; chunking is a runtime detail
+inline void to_json(nlohmann::json& j, const TilemapComponent& comp) {
+    std::vector<int> tiles;
+    tiles.reserve(static_cast<size_t>(comp.width) * comp.height);
+    for (int ty = 0; ty < comp.height; ++ty) {
+        for (int tx = 0; tx < comp.width; ++tx) {
+            tiles.push_back(comp.getTile(tx, ty));
+        }
+    }
+
+    j = nlohmann::json{
+        {"tilesetTextureId", comp.tilesetTextureId},
+        {"tileWidth", comp.tileWidth},
+        {"tileHeight", comp.tileHeight},
+        {"tilesetColumns", comp.tilesetColumns},
+        {"width", comp.width},
+        {"height", comp.height},
+        {"generateCollision", comp.generateCollision},
+        {"allTilesSolid", comp.allTilesSolid},
+        {"solidTileIds", comp.solidTileIds},
+        {"tiles", tiles}
+    };
+}
+
+inline void from_json(const nlohmann::json& j, TilemapComponent& comp) {
+    comp.tilesetTextureId = j.value("tilesetTextureId", "");
+    comp.tileWidth = j.value("tileWidth", 32);
+    comp.tileHeight = j.value("tileHeight", 32);
+    comp.tilesetColumns = j.value("tilesetColumns", 1);
+    comp.generateCollision = j.value("generateCollision", true);
+    comp.allTilesSolid = j.value("allTilesSolid", true);
+    comp.solidTileIds = j.value("solidTileIds", std::vector<int>{});
+
+    comp.width = 0;
+    comp.height = 0;
+    comp.resize(j.value("width", 0), j.value("height", 0));
+
+    if (j.contains("tiles") && j["tiles"].is_array()) {
+        const auto& tiles = j["tiles"];
+        size_t count = std::min(tiles.size(), static_cast<size_t>(comp.width) * comp.height);
+        for (size_t i = 0; i < count; ++i) {
+            comp.setTile(static_cast<int>(i % comp.width), static_cast<int>(i / comp.width), tiles[i].get<int>());
+        }
+    }
+}
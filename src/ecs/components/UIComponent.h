@@ -109,6 +109,10 @@ struct UIComponent {
     bool focusable = false;
     int zOrder = 0;
     
+    // Retained rendering: bake this subtree into a texture and reuse it until it changes
+    // (roots with children are cached automatically unless they change every frame)
+    bool cacheAsTexture = false;
+    
     // Layout properties
     UILayoutType layoutType = UILayoutType::NONE;
     float layoutSpacing = 5.0f;
@@ -268,6 +272,7 @@ inline void to_json(nlohmann::json& j, const UIComponent& comp) {
         {"interactive", comp.interactive},
         {"focusable", comp.focusable},
         {"zOrder", comp.zOrder},
+        {"cacheAsTexture", comp.cacheAsTexture},
         {"layoutType", static_cast<int>(comp.layoutType)},
         {"layoutSpacing", comp.layoutSpacing},
         {"gridColumns", comp.gridColumns}
@@ -300,6 +305,7 @@ inline void from_json(const nlohmann::json& j, UIComponent& comp) {
     comp.interactive = j.value("interactive", true);
     comp.focusable = j.value("focusable", false);
     comp.zOrder = j.value("zOrder", 0);
+    comp.cacheAsTexture = j.value("cacheAsTexture", false);
     comp.layoutType = static_cast<UILayoutType>(j.value("layoutType", 0));
     comp.layoutSpacing = j.value("layoutSpacing", 5.0f);
     comp.gridColumns = j.value("gridColumns", 1);
@@ -39,11 +39,21 @@ inline bool verticalLineIntersectsAABB(float x, float y0, float y1, const FloatR
     return true;
 }
 
+// World-space solid area that does not live in the quadtree (e.g. merged tilemap collision)
+struct StaticCollider {
+    Entity owner;
+    FloatRect rect;
+};
+
 class CollisionSystem : public System {
 public:
     std::unique_ptr<Quadtree> quadtree;
     int entitiesInsertedIntoQuadtree = 0;
 
+    void setStaticColliders(const std::vector<StaticCollider>& colliders) {
+        staticColliders = colliders;
+    }
+
     CollisionSystem(float worldWidth = 2000.0f, float worldHeight = 1500.0f) { 
         std::cout << "[CollisionSystem] Constructor called. World: " << worldWidth << "x" << worldHeight << std::endl;
         SDL_Rect worldBounds = {0, 0, static_cast<int>(worldWidth), static_cast<int>(worldHeight)};
@@ -166,6 +176,23 @@ public:
                         }
                     }
 
+                    if (!sweptCollision && !colliderA.isTrigger) {
+                        float sweptPointX = transformA.x + colliderA.offsetX + colliderA.width / 2.0f;
+                        float edgeOffset = velocityA.vy > 0 ? colliderA.offsetY + colliderA.height : colliderA.offsetY;
+                        for (const auto& staticCollider : staticColliders) {
+                            float collisionResolutionY = 0.0f;
+                            if (verticalLineIntersectsAABB(sweptPointX, oldY + edgeOffset, newY + edgeOffset, staticCollider.rect, collisionResolutionY)) {
+                                float candidateY = collisionResolutionY - edgeOffset;
+                                // Merged rects can overlap the sweep in any order, keep the nearest hit
+                                if (!sweptCollision || (velocityA.vy > 0 ? candidateY < sweptY : candidateY > sweptY)) {
+                                    sweptY = candidateY;
+                                    entityB_swept_collider = staticCollider.owner;
+                                }
+                                sweptCollision = true;
+                            }
+                        }
+                    }
+
                     if (sweptCollision) {
                         float originalVy = velocityA.vy;
                         transformA.y = sweptY;
@@ -202,6 +229,7 @@ public:
                             checkRectA.h = 0.1f;
                         }
 
+                        bool restingContact = false;
                         for (auto const& entityB : potentialColliders) {
                              if (entityA == entityB) continue;
                              if (!componentManager->hasComponent<TransformComponent>(entityB) ||
@@ -227,12 +255,24 @@ public:
                                     colliderB_comp.contacts.push_back({entityA, {0, 1}});
                                 }
                                 std::cout << "[Discrete Check] Entity " << entityA << " in resting contact with " << entityB << std::endl;
-                               
+                                restingContact = true;
                                 break;
                              }
                         }
+
+                        if (!restingContact && !colliderA.isTrigger) {
+                            for (const auto& staticCollider : staticColliders) {
+                                if (checkFloatAABBCollision(checkRectA, staticCollider.rect)) {
+                                    colliderA.contacts.push_back({staticCollider.owner, {0, -1}});
+                                    break;
+                                }
+                            }
+                        }
                 }
             }
         }
     }
+
+private:
+    std::vector<StaticCollider> staticColliders;
 };
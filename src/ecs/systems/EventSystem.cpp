@@ -1,10 +1,13 @@
 #include "EventSystem.h"
 #include <algorithm>
 #include <chrono>
+#include <iterator>
 
 int EventSystem::nextEventId = 0;
 
-EventSystem::EventSystem() {
+EventSystem::EventSystem()
+    : indexedRevision(MAX_ENTITIES, 0), indexedKeys(MAX_ENTITIES) {
+    eventHistory.setCapacity(static_cast<size_t>(maxEventHistorySize));
     std::cout << "[EventSystem] Initialized" << std::endl;
 }
 
@@ -17,11 +20,12 @@ void EventSystem::update(ComponentManager* componentManager, float deltaTime) {
     metrics.globalBroadcasts = 0;
     metrics.targetedEvents = 0;
     
-    // Process outgoing events from all entities
-    processOutgoingEvents(componentManager);
+    // Pick up listener changes since last frame
+    refreshSubscriptions(componentManager);
     
-    // Process the global event queue
-    processEventQueue(componentManager);
+    // Seal everything emitted since the last update into this frame, then dispatch it
+    sealFrame(componentManager);
+    dispatchFrame(componentManager);
     
     // Generate built-in events
     generateTimerEvents(componentManager, deltaTime);
@@ -32,7 +36,13 @@ void EventSystem::update(ComponentManager* componentManager, float deltaTime) {
     // Update performance metrics
     auto endTime = std::chrono::high_resolution_clock::now();
     metrics.processingTime = std::chrono::duration<float, std::milli>(endTime - frameStartTime).count();
-    metrics.eventQueueSize = static_cast<int>(eventQueue.size());
+    metrics.eventQueueSize = static_cast<int>(eventQueue.sizeApprox() + writeFrame.size() + carriedOver.size());
+    
+    int dropped = droppedEvents.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        metrics.droppedEvents += dropped;
+        std::cerr << "[EventSystem] Event queue full, dropped " << dropped << " events" << std::endl;
+    }
     
     // Reset frame counters for all event components
     for (auto const& entity : entities) {
@@ -61,16 +71,17 @@ void EventSystem::processOutgoingEvents(ComponentManager* componentManager) {
             event.timestamp = std::chrono::duration<float>(
                 std::chrono::steady_clock::now().time_since_epoch()).count();
             
-            // Add to global event queue
-            eventQueue.push(event);
-            
-            // Add to history
-            addToHistory(event);
-            eventComp.addToHistory(event);
+            if (historyEnabled) {
+                eventComp.addToHistory(event);
+            }
             
             if (debugLogging) {
                 logEvent(event, "SENT");
             }
+            
+            // Straight into the frame being collected; the ring is only needed for other threads
+            event.sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+            writeFrame.push_back(std::move(event));
         }
         
         // Clear outgoing events
@@ -78,24 +89,98 @@ void EventSystem::processOutgoingEvents(ComponentManager* componentManager) {
     }
 }
 
-void EventSystem::processEventQueue(ComponentManager* componentManager) {
-    int eventsProcessed = 0;
+void EventSystem::sealFrame(ComponentManager* componentManager) {
+    EventData event;
+    while (eventQueue.tryPop(event)) {
+        writeFrame.push_back(std::move(event));
+    }
+    processOutgoingEvents(componentManager);
     
-    while (!eventQueue.empty() && eventsProcessed < maxEventsPerFrame) {
-        EventData event = eventQueue.front();
-        eventQueue.pop();
-        
+    readFrame.clear();
+    std::swap(readFrame, writeFrame);
+    frameNumber++;
+    
+    // Deterministic regardless of which system or thread emitted first
+    std::sort(readFrame.begin(), readFrame.end(), [](const EventData& a, const EventData& b) {
+        if (a.sender != b.sender) return a.sender < b.sender;
+        return a.sequence < b.sequence;
+    });
+    
+    // Events carried over from a capped frame go first, in their original order, so high-id
+    // senders are delayed by the cap rather than starved by newer events from low ids
+    if (!carriedOver.empty()) {
+        carriedOver.insert(carriedOver.end(), std::make_move_iterator(readFrame.begin()), std::make_move_iterator(readFrame.end()));
+        std::swap(readFrame, carriedOver);
+        carriedOver.clear();
+    }
+    
+    metrics.deferredEvents = 0;
+    if (maxEventsPerFrame > 0 && readFrame.size() > static_cast<size_t>(maxEventsPerFrame)) {
+        auto firstDeferred = readFrame.begin() + maxEventsPerFrame;
+        metrics.deferredEvents = static_cast<int>(readFrame.end() - firstDeferred);
+        carriedOver.assign(std::make_move_iterator(firstDeferred), std::make_move_iterator(readFrame.end()));
+        readFrame.erase(firstDeferred, readFrame.end());
+    }
+}
+
+void EventSystem::dispatchFrame(ComponentManager* componentManager) {
+    for (const EventData& event : readFrame) {
         if (!isValidEvent(event)) {
             continue;
         }
         
+        if (historyEnabled) {
+            addToHistory(event);
+        }
+        
         deliverEvent(event, componentManager);
-        eventsProcessed++;
         metrics.eventsThisFrame++;
         metrics.totalEventsProcessed++;
     }
 }
 
+const EventData* EventSystem::readNext(EventCursor& cursor) const {
+    // A cursor from an older frame restarts at the current one; unread events of past frames are gone
+    if (cursor.frame != frameNumber) {
+        cursor.frame = frameNumber;
+        cursor.position = 0;
+    }
+    if (cursor.position >= readFrame.size()) return nullptr;
+    return &readFrame[cursor.position++];
+}
+
+const EventData* EventSystem::readNext(EventCursor& cursor, EventType type) const {
+    while (const EventData* event = readNext(cursor)) {
+        if (event->type == type) return event;
+    }
+    return nullptr;
+}
+
+std::vector<EventData> EventSystem::getEventsOfType(EventType type) const {
+    std::vector<EventData> result;
+    for (const auto& event : readFrame) {
+        if (event.type == type) result.push_back(event);
+    }
+    return result;
+}
+
+std::vector<EventData> EventSystem::getEventsWithName(const std::string& eventName) const {
+    std::vector<EventData> result;
+    EventNameId nameId = EventNames::find(eventName);
+    for (const auto& event : readFrame) {
+        if (event.nameId == nameId) result.push_back(event);
+    }
+    return result;
+}
+
+std::vector<EventData> EventSystem::getEventsFromSender(Entity sender) const {
+    std::vector<EventData> result;
+    for (const auto& event : readFrame) {
+        if (event.sender == sender) result.push_back(event);
+    }
+    return result;
+}
+
 void EventSystem::deliverEvent(const EventData& event, ComponentManager* componentManager) {
     if (event.target != NO_ENTITY) {
         // Targeted event - deliver to specific entity
@@ -103,65 +188,152 @@ void EventSystem::deliverEvent(const EventData& event, ComponentManager* compone
             auto& targetEventComp = componentManager->getComponent<EventComponent>(event.target);
             
             // Process listeners for this specific entity
-            for (auto it = targetEventComp.listeners.begin(); it != targetEventComp.listeners.end();) {
-                if (shouldDeliverEvent(event, event.target, *it)) {
-                    try {
-                        it->callback(event);
-                        metrics.listenersTriggered++;
-                        targetEventComp.eventsProcessedThisFrame++;
-                        
-                        if (debugLogging) {
-                            logEvent(event, "DELIVERED_TO_TARGET");
-                        }
-                        
-                        // Remove one-shot listeners
-                        if (it->oneShot) {
-                            it = targetEventComp.listeners.erase(it);
-                            continue;
-                        }
-                    } catch (const std::exception& e) {
-                        std::cerr << "[EventSystem] Error in event listener: " << e.what() << std::endl;
+            for (size_t i = 0; i < targetEventComp.listeners.size();) {
+                auto& listener = targetEventComp.listeners[i];
+                if (shouldDeliverEvent(event, event.target, listener)) {
+                    if (listener.oneShot) {
+                        // Detach first so the callback may safely register listeners
+                        EventListenerRegistration once = std::move(listener);
+                        targetEventComp.listeners.erase(targetEventComp.listeners.begin() + i);
+                        targetEventComp.touchListeners();
+                        invokeListener(event, event.target, targetEventComp, once, false);
+                        continue;
                     }
+                    invokeListener(event, event.target, targetEventComp, listener, false);
                 }
-                ++it;
+                ++i;
             }
         }
         metrics.targetedEvents++;
     } else {
-        // Broadcast event - deliver to all entities with listeners
-        for (auto const& entity : entities) {
-            if (!componentManager->hasComponent<EventComponent>(entity)) continue;
-            
-            auto& eventComp = componentManager->getComponent<EventComponent>(entity);
-            
-            // Process listeners for this entity
-            for (auto it = eventComp.listeners.begin(); it != eventComp.listeners.end();) {
-                if (shouldDeliverEvent(event, entity, *it)) {
-                    try {
-                        it->callback(event);
-                        metrics.listenersTriggered++;
-                        eventComp.eventsProcessedThisFrame++;
-                        
-                        if (debugLogging) {
-                            logEvent(event, "BROADCAST_TO_" + std::to_string(entity));
-                        }
-                        
-                        // Remove one-shot listeners
-                        if (it->oneShot) {
-                            it = eventComp.listeners.erase(it);
-                            continue;
-                        }
-                    } catch (const std::exception& e) {
-                        std::cerr << "[EventSystem] Error in event listener: " << e.what() << std::endl;
-                    }
+        // Broadcast event - deliver to the indexed subscribers of this (type, name)
+        auto found = subscriptionIndex.find(subscriptionKey(event.type, event.nameId));
+        if (found != subscriptionIndex.end()) {
+            const std::vector<Subscription>& subscribers = found->second;
+            for (size_t i = 0; i < subscribers.size(); ++i) {
+                const Subscription subscription = subscribers[i];
+                // Don't deliver to sender
+                if (subscription.entity == event.sender) continue;
+                if (!componentManager->hasComponent<EventComponent>(subscription.entity)) continue;
+                
+                auto& eventComp = componentManager->getComponent<EventComponent>(subscription.entity);
+                EventListenerRegistration* listener = eventComp.findListener(subscription.listenerId);
+                if (!listener) continue; // Removed since the last refresh
+                
+                if (listener->oneShot) {
+                    EventListenerRegistration once = std::move(*listener);
+                    eventComp.removeListenerById(subscription.listenerId);
+                    pendingReindex.push_back(subscription.entity);
+                    invokeListener(event, subscription.entity, eventComp, once, true);
+                } else {
+                    invokeListener(event, subscription.entity, eventComp, *listener, true);
                 }
-                ++it;
             }
         }
         metrics.globalBroadcasts++;
+        
+        // One-shot removals are applied to the index once the subscriber list is no longer in use
+        for (Entity entity : pendingReindex) {
+            unindexEntity(entity);
+            if (componentManager->hasComponent<EventComponent>(entity)) {
+                indexEntity(entity, componentManager->getComponent<EventComponent>(entity));
+            }
+        }
+        pendingReindex.clear();
     }
 }
 
+void EventSystem::invokeListener(const EventData& event, Entity entity, EventComponent& eventComp,
+                                 EventListenerRegistration& listener, bool broadcast) {
+    try {
+        listener.callback(event);
+        metrics.listenersTriggered++;
+        eventComp.eventsProcessedThisFrame++;
+        
+        if (debugLogging) {
+            logEvent(event, broadcast ? "BROADCAST_TO_" + std::to_string(entity) : "DELIVERED_TO_TARGET");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[EventSystem] Error in event listener: " << e.what() << std::endl;
+    }
+}
+
+std::uint64_t EventSystem::subscriptionKey(EventType type, EventNameId nameId) {
+    // Only custom events are filtered by name; other listeners match every event of their type
+    EventNameId keyName = (type == EventType::CUSTOM_EVENT) ? nameId : NO_EVENT_NAME;
+    return (static_cast<std::uint64_t>(type) << 32) | keyName;
+}
+
+void EventSystem::refreshSubscriptions(ComponentManager* componentManager) {
+    // Drop entities that left the system or lost their EventComponent
+    for (size_t i = 0; i < indexedEntities.size();) {
+        Entity entity = indexedEntities[i];
+        if (entities.count(entity) == 0 || !componentManager->hasComponent<EventComponent>(entity)) {
+            unindexEntity(entity);
+            indexedEntities[i] = indexedEntities.back();
+            indexedEntities.pop_back();
+            continue;
+        }
+        ++i;
+    }
+    
+    for (auto const& entity : entities) {
+        if (!componentManager->hasComponent<EventComponent>(entity)) continue;
+        auto& eventComp = componentManager->getComponent<EventComponent>(entity);
+        // A fresh component has revision 0; give it a real one so it differs from any stale entry
+        if (eventComp.listenerRevision == 0) eventComp.touchListeners();
+        if (indexedRevision[entity] == eventComp.listenerRevision) continue;
+        
+        bool wasIndexed = indexedRevision[entity] != 0;
+        unindexEntity(entity);
+        indexEntity(entity, eventComp);
+        if (!wasIndexed) indexedEntities.push_back(entity);
+        metrics.subscriptionReindexes++;
+    }
+}
+
+void EventSystem::indexEntity(Entity entity, const EventComponent& eventComp) {
+    auto& keys = indexedKeys[entity];
+    for (const auto& listener : eventComp.listeners) {
+        std::uint64_t key = subscriptionKey(listener.eventType, listener.nameId);
+        std::vector<Subscription>& subscribers = subscriptionIndex[key];
+        
+        // Higher priority first; ties keep entity order, then registration order
+        Subscription subscription{entity, listener.id, listener.priority};
+        auto position = std::upper_bound(subscribers.begin(), subscribers.end(), subscription,
+            [](const Subscription& a, const Subscription& b) {
+                if (a.priority != b.priority) return a.priority > b.priority;
+                if (a.entity != b.entity) return a.entity < b.entity;
+                return a.listenerId < b.listenerId;
+            });
+        subscribers.insert(position, subscription);
+        metrics.indexedSubscriptions++;
+        
+        if (std::find(keys.begin(), keys.end(), key) == keys.end()) {
+            keys.push_back(key);
+        }
+    }
+    indexedRevision[entity] = eventComp.listenerRevision;
+}
+
+void EventSystem::unindexEntity(Entity entity) {
+    for (std::uint64_t key : indexedKeys[entity]) {
+        auto found = subscriptionIndex.find(key);
+        if (found == subscriptionIndex.end()) continue;
+        auto& subscribers = found->second;
+        size_t before = subscribers.size();
+        subscribers.erase(
+            std::remove_if(subscribers.begin(), subscribers.end(),
+                [entity](const Subscription& subscription) {
+                    return subscription.entity == entity;
+                }),
+            subscribers.end());
+        metrics.indexedSubscriptions -= static_cast<int>(before - subscribers.size());
+    }
+    indexedKeys[entity].clear();
+    indexedRevision[entity] = 0;
+}
+
 bool EventSystem::shouldDeliverEvent(const EventData& event, Entity target, const EventListenerRegistration& listener) const {
     // Check event type match
     if (listener.eventType != event.type) {
@@ -170,7 +342,7 @@ bool EventSystem::shouldDeliverEvent(const EventData& event, Entity target, cons
     
     // For custom events, check name match
     if (event.type == EventType::CUSTOM_EVENT) {
-        if (listener.eventName != event.eventName) {
+        if (listener.nameId != event.nameId) {
             return false;
         }
     }
@@ -197,47 +369,59 @@ bool EventSystem::isValidEvent(const EventData& event) const {
     return true;
 }
 
+bool EventSystem::enqueue(EventData&& event) {
+    event.sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+    if (eventQueue.tryPush(std::move(event))) {
+        return true;
+    }
+    droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
 void EventSystem::broadcastEvent(const EventData& event) {
-    EventData broadcastEvent = event;
-    broadcastEvent.target = NO_ENTITY; // Ensure it's a broadcast
-    eventQueue.push(broadcastEvent);
-    addToHistory(broadcastEvent);
+    broadcastEvent(EventData(event));
+}
+
+void EventSystem::broadcastEvent(EventData&& event) {
+    event.target = NO_ENTITY; // Ensure it's a broadcast
+    enqueue(std::move(event));
 }
 
 void EventSystem::broadcastEvent(EventType type, Entity sender, const std::string& eventName) {
-    EventData event(type, sender, NO_ENTITY, eventName);
-    broadcastEvent(event);
+    broadcastEvent(EventData(type, sender, NO_ENTITY, eventName));
 }
 
 void EventSystem::broadcastCustomEvent(const std::string& eventName, Entity sender) {
-    EventData event(EventType::CUSTOM_EVENT, sender, NO_ENTITY, eventName);
-    broadcastEvent(event);
+    broadcastEvent(EventData(EventType::CUSTOM_EVENT, sender, NO_ENTITY, eventName));
 }
 
 void EventSystem::sendEventToEntity(Entity target, const EventData& event) {
-    EventData targetedEvent = event;
-    targetedEvent.target = target;
-    eventQueue.push(targetedEvent);
-    addToHistory(targetedEvent);
+    sendEventToEntity(target, EventData(event));
+}
+
+void EventSystem::sendEventToEntity(Entity target, EventData&& event) {
+    event.target = target;
+    enqueue(std::move(event));
 }
 
 void EventSystem::sendEventToEntity(Entity target, EventType type, Entity sender, const std::string& eventName) {
-    EventData event(type, sender, target, eventName);
-    sendEventToEntity(target, event);
+    sendEventToEntity(target, EventData(type, sender, target, eventName));
 }
 
 void EventSystem::logEvent(const EventData& event, const std::string& action) const {
     std::cout << "[EventSystem] " << action << " - Type: " << static_cast<int>(event.type) 
-              << ", Name: " << event.eventName 
+              << ", Name: " << event.eventName() 
               << ", Sender: " << event.sender 
               << ", Target: " << event.target << std::endl;
 }
 
 void EventSystem::addToHistory(const EventData& event) {
-    eventHistory.push_back(event);
-    if (eventHistory.size() > maxEventHistorySize) {
-        eventHistory.erase(eventHistory.begin());
-    }
+    eventHistory.push(event);
+}
+
+void EventSystem::setEventHistorySize(int size) {
+    maxEventHistorySize = std::max(0, size);
+    eventHistory.setCapacity(static_cast<size_t>(maxEventHistorySize));
 }
 
 void EventSystem::cleanupExpiredEvents() {
@@ -246,7 +430,9 @@ void EventSystem::cleanupExpiredEvents() {
 }
 
 void EventSystem::resetMetrics() {
+    int indexedSubscriptions = metrics.indexedSubscriptions;
     metrics = PerformanceMetrics{};
+    metrics.indexedSubscriptions = indexedSubscriptions;
 }
 
 void EventSystem::generateTimerEvents(ComponentManager* componentManager, float deltaTime) {
@@ -266,26 +452,59 @@ void EventSystem::generateInputEvents(ComponentManager* componentManager) {
 
 // Event utility functions
 namespace EventUtils {
+    namespace {
+        // Keys used by the built-in helpers, interned once
+        struct BuiltInKeys {
+            EventNameId collision = EventNames::intern("collision");
+            EventNameId collisionType = EventNames::intern("collisionType");
+            EventNameId entity1 = EventNames::intern("entity1");
+            EventNameId entity2 = EventNames::intern("entity2");
+            EventNameId key = EventNames::intern("key");
+            EventNameId pressed = EventNames::intern("pressed");
+            EventNameId timerName = EventNames::intern("timerName");
+            EventNameId duration = EventNames::intern("duration");
+            EventNameId position = EventNames::intern("position");
+            EventNameId x = EventNames::intern("x");
+            EventNameId y = EventNames::intern("y");
+            EventNameId velocity = EventNames::intern("velocity");
+            EventNameId vx = EventNames::intern("vx");
+            EventNameId vy = EventNames::intern("vy");
+            EventNameId health = EventNames::intern("health");
+            EventNameId maxHealth = EventNames::intern("maxHealth");
+            EventNameId healthPercent = EventNames::intern("healthPercent");
+            EventNameId score = EventNames::intern("score");
+            EventNameId scoreDelta = EventNames::intern("scoreDelta");
+        };
+
+        const BuiltInKeys& keys() {
+            static const BuiltInKeys builtInKeys;
+            return builtInKeys;
+        }
+    }
+
     EventData createCollisionEvent(Entity entity1, Entity entity2, const std::string& collisionType) {
-        EventData event(EventType::COLLISION_ENTER, entity1, entity2, "collision");
-        event.setParameter("collisionType", collisionType);
-        event.setParameter("entity1", static_cast<int>(entity1));
-        event.setParameter("entity2", static_cast<int>(entity2));
+        const BuiltInKeys& k = keys();
+        EventData event(EventType::COLLISION_ENTER, entity1, entity2, k.collision);
+        event.setParameter(k.collisionType, collisionType);
+        event.setParameterEntity(k.entity1, entity1);
+        event.setParameterEntity(k.entity2, entity2);
         return event;
     }
     
     EventData createInputEvent(const std::string& inputName, bool pressed, Entity target) {
+        const BuiltInKeys& k = keys();
         EventType type = pressed ? EventType::INPUT_KEY_DOWN : EventType::INPUT_KEY_UP;
         EventData event(type, NO_ENTITY, target, inputName);
-        event.setParameter("key", inputName);
-        event.setParameter("pressed", pressed ? "true" : "false");
+        event.setParameter(k.key, inputName);
+        event.setParameter(k.pressed, pressed ? "true" : "false");
         return event;
     }
     
     EventData createTimerEvent(Entity entity, const std::string& timerName, float duration) {
+        const BuiltInKeys& k = keys();
         EventData event(EventType::TIMER_EXPIRED, entity, entity, timerName);
-        event.setParameter("timerName", timerName);
-        event.setParameter("duration", duration);
+        event.setParameter(k.timerName, timerName);
+        event.setParameter(k.duration, duration);
         return event;
     }
     
@@ -293,25 +512,32 @@ namespace EventUtils {
         return EventData(EventType::CUSTOM_EVENT, sender, target, eventName);
     }
     
+    // Position and velocity are stored both as a vec2 and as the scalar keys older listeners read
     void addPositionParameter(EventData& event, float x, float y) {
-        event.setParameter("x", x);
-        event.setParameter("y", y);
+        const BuiltInKeys& k = keys();
+        event.setParameterVec2(k.position, x, y);
+        event.setParameter(k.x, x);
+        event.setParameter(k.y, y);
     }
     
     void addVelocityParameter(EventData& event, float vx, float vy) {
-        event.setParameter("vx", vx);
-        event.setParameter("vy", vy);
+        const BuiltInKeys& k = keys();
+        event.setParameterVec2(k.velocity, vx, vy);
+        event.setParameter(k.vx, vx);
+        event.setParameter(k.vy, vy);
     }
     
     void addHealthParameter(EventData& event, float health, float maxHealth) {
-        event.setParameter("health", health);
-        event.setParameter("maxHealth", maxHealth);
-        event.setParameter("healthPercent", (health / maxHealth) * 100.0f);
+        const BuiltInKeys& k = keys();
+        event.setParameter(k.health, health);
+        event.setParameter(k.maxHealth, maxHealth);
+        event.setParameter(k.healthPercent, (health / maxHealth) * 100.0f);
     }
     
     void addScoreParameter(EventData& event, int score, int delta) {
-        event.setParameter("score", score);
-        event.setParameter("scoreDelta", delta);
+        const BuiltInKeys& k = keys();
+        event.setParameter(k.score, score);
+        event.setParameter(k.scoreDelta, delta);
     }
     
     std::string eventTypeToString(EventType type) {
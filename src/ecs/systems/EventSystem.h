@@ -4,7 +4,8 @@
 #include "../ComponentManager.h"
 #include "../components/EventComponent.h"
 #include "../components/TransformComponent.h"
-#include <queue>
+#include "../../events/EventRing.h"
+#include <atomic>
 #include <unordered_map>
 #include <chrono>
 #include <iostream>
@@ -16,16 +17,33 @@ public:
     
     void update(ComponentManager* componentManager, float deltaTime);
     
-    // Global event broadcasting
+    // Global event broadcasting. Broadcasting and targeted sends only enqueue, and are safe to
+    // call from any thread (audio, physics, workers); delivery happens on the next update.
     void broadcastEvent(const EventData& event);
+    void broadcastEvent(EventData&& event);
     void broadcastEvent(EventType type, Entity sender, const std::string& eventName = "");
     void broadcastCustomEvent(const std::string& eventName, Entity sender);
     
     // Targeted event sending
     void sendEventToEntity(Entity target, const EventData& event);
+    void sendEventToEntity(Entity target, EventData&& event);
     void sendEventToEntity(Entity target, EventType type, Entity sender, const std::string& eventName = "");
     
-    // Event filtering and querying
+    // Double-buffered event stream: everything emitted between two updates (including by
+    // listeners during dispatch) is sealed into one frame, ordered by (sender, sequence) after any
+    // events carried over from a capped frame, and dispatched on the next update. The dispatched
+    // frame stays readable until the following update, so any number of systems can walk it with
+    // their own cursor without copying.
+    struct EventCursor {
+        std::uint64_t frame = 0;
+        size_t position = 0;
+    };
+    const EventData* readNext(EventCursor& cursor) const;
+    const EventData* readNext(EventCursor& cursor, EventType type) const;
+    const std::vector<EventData>& getFrameEvents() const { return readFrame; }
+    std::uint64_t getFrameNumber() const { return frameNumber; }
+    
+    // Event filtering and querying (copies from the current frame)
     std::vector<EventData> getEventsOfType(EventType type) const;
     std::vector<EventData> getEventsWithName(const std::string& eventName) const;
     std::vector<EventData> getEventsFromSender(Entity sender) const;
@@ -36,17 +54,24 @@ public:
         int eventsThisFrame = 0;
         int listenersTriggered = 0;
         int eventQueueSize = 0;
+        int droppedEvents = 0;
+        int deferredEvents = 0;
         float processingTime = 0.0f;
         int globalBroadcasts = 0;
         int targetedEvents = 0;
+        int indexedSubscriptions = 0;
+        int subscriptionReindexes = 0;
     };
     
     const PerformanceMetrics& getMetrics() const { return metrics; }
     void resetMetrics();
     
     // Event system configuration
+    // Frames larger than this dispatch their first maxEvents events and carry the rest over
     void setMaxEventsPerFrame(int maxEvents) { maxEventsPerFrame = maxEvents; }
-    void setEventHistorySize(int size) { maxEventHistorySize = size; }
+    void setEventHistorySize(int size);
+    // Per-entity history feeds event-triggered state transitions; disable only if none are used
+    void enableHistory(bool enable) { historyEnabled = enable; }
     void enableDebugLogging(bool enable) { debugLogging = enable; }
     
     // Built-in event generators
@@ -58,15 +83,48 @@ private:
     // Event processing
     void processOutgoingEvents(ComponentManager* componentManager);
     void deliverEvent(const EventData& event, ComponentManager* componentManager);
-    void processEventQueue(ComponentManager* componentManager);
+    void sealFrame(ComponentManager* componentManager);
+    void dispatchFrame(ComponentManager* componentManager);
+    void invokeListener(const EventData& event, Entity entity, EventComponent& eventComp,
+                        EventListenerRegistration& listener, bool broadcast);
+    
+    // Subscription index: broadcasts look up their (type, name) subscriber list instead of
+    // visiting every entity. Refreshed once per frame from EventComponent::listenerRevision;
+    // listeners registered mid-frame start receiving broadcasts on the next update.
+    struct Subscription {
+        Entity entity;
+        std::uint32_t listenerId;
+        int priority;
+    };
+    static std::uint64_t subscriptionKey(EventType type, EventNameId nameId);
+    void refreshSubscriptions(ComponentManager* componentManager);
+    void indexEntity(Entity entity, const EventComponent& eventComp);
+    void unindexEntity(Entity entity);
+    
+    std::unordered_map<std::uint64_t, std::vector<Subscription>> subscriptionIndex;
+    std::vector<std::uint32_t> indexedRevision;              // Per entity, 0 when not indexed
+    std::vector<std::vector<std::uint64_t>> indexedKeys;     // Per entity, keys it appears under
+    std::vector<Entity> indexedEntities;
+    std::vector<Entity> pendingReindex;                      // Entities that lost one-shot listeners
     
     // Event validation and filtering
     bool isValidEvent(const EventData& event) const;
     bool shouldDeliverEvent(const EventData& event, Entity target, const EventListenerRegistration& listener) const;
     
-    // Internal event queue for frame-based processing
-    std::queue<EventData> eventQueue;
-    std::vector<EventData> eventHistory;
+    // Internal event queue for frame-based processing; full queue drops (and counts) new events
+    static const size_t EVENT_QUEUE_CAPACITY = 4096;
+    bool enqueue(EventData&& event);
+    MPSCRing<EventData> eventQueue{EVENT_QUEUE_CAPACITY};
+    std::atomic<int> droppedEvents{0};
+    std::atomic<std::uint64_t> nextSequence{0};
+    
+    // Event frames: writeFrame collects until the next update, readFrame is being dispatched/read
+    std::vector<EventData> writeFrame;
+    std::vector<EventData> readFrame;
+    std::vector<EventData> carriedOver;   // Cut from the last frame by maxEventsPerFrame; dispatched first
+    std::uint64_t frameNumber = 0;
+    HistoryRing<EventData> eventHistory;
+    bool historyEnabled = true;
     
     // Configuration
     int maxEventsPerFrame = 1000;
@@ -1,11 +1,102 @@
 #include "ParticleSystem.h"
+#include "../EntityManager.h"
+#include "../SystemManager.h"
 #include <chrono>
 #include <algorithm>
+#include <functional>
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLE_SIMD_SSE 1
+#endif
+
+namespace {
+    // Kernels over the packed live range of a ParticleComponent. Each has an AVX (8-wide) or
+    // SSE (4-wide) body when the compiler targets it, with the scalar loop handling the tail
+    // and acting as the fallback everywhere else.
+
+    void advanceLife(float* life, int count, float deltaTime) {
+        int i = 0;
+#if defined(__AVX__)
+        const __m256 dt8 = _mm256_set1_ps(deltaTime);
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_ps(life + i, _mm256_add_ps(_mm256_loadu_ps(life + i), dt8));
+        }
+#elif defined(PARTICLE_SIMD_SSE)
+        const __m128 dt4 = _mm_set1_ps(deltaTime);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(life + i, _mm_add_ps(_mm_loadu_ps(life + i), dt4));
+        }
+#endif
+        for (; i < count; ++i) {
+            life[i] += deltaTime;
+        }
+    }
+
+    // v = (v + g * dt) * damping; p += v * scale * dt, with scale the velocity-over-lifetime
+    // multiplier per particle (nullptr for none)
+    void integrateAxis(float* position, float* velocity, const float* scale, int count,
+                       float gravity, float damping, float deltaTime) {
+        int i = 0;
+#if defined(__AVX__)
+        const __m256 accel8 = _mm256_set1_ps(gravity * deltaTime);
+        const __m256 damping8 = _mm256_set1_ps(damping);
+        const __m256 dt8 = _mm256_set1_ps(deltaTime);
+        for (; i + 8 <= count; i += 8) {
+            __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(velocity + i), accel8), damping8);
+            _mm256_storeu_ps(velocity + i, v);
+            __m256 step = scale ? _mm256_mul_ps(v, _mm256_mul_ps(_mm256_loadu_ps(scale + i), dt8)) : _mm256_mul_ps(v, dt8);
+            _mm256_storeu_ps(position + i, _mm256_add_ps(_mm256_loadu_ps(position + i), step));
+        }
+#elif defined(PARTICLE_SIMD_SSE)
+        const __m128 accel4 = _mm_set1_ps(gravity * deltaTime);
+        const __m128 damping4 = _mm_set1_ps(damping);
+        const __m128 dt4 = _mm_set1_ps(deltaTime);
+        for (; i + 4 <= count; i += 4) {
+            __m128 v = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velocity + i), accel4), damping4);
+            _mm_storeu_ps(velocity + i, v);
+            __m128 step = scale ? _mm_mul_ps(v, _mm_mul_ps(_mm_loadu_ps(scale + i), dt4)) : _mm_mul_ps(v, dt4);
+            _mm_storeu_ps(position + i, _mm_add_ps(_mm_loadu_ps(position + i), step));
+        }
+#endif
+        const float accel = gravity * deltaTime;
+        for (; i < count; ++i) {
+            velocity[i] = (velocity[i] + accel) * damping;
+            position[i] += velocity[i] * (scale ? scale[i] : 1.0f) * deltaTime;
+        }
+    }
+
+    // p += v * dt, used for rotation
+    void advanceLinear(float* value, const float* rate, int count, float deltaTime) {
+        int i = 0;
+#if defined(__AVX__)
+        const __m256 dt8 = _mm256_set1_ps(deltaTime);
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_ps(value + i, _mm256_add_ps(_mm256_loadu_ps(value + i), _mm256_mul_ps(_mm256_loadu_ps(rate + i), dt8)));
+        }
+#elif defined(PARTICLE_SIMD_SSE)
+        const __m128 dt4 = _mm_set1_ps(deltaTime);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(value + i, _mm_add_ps(_mm_loadu_ps(value + i), _mm_mul_ps(_mm_loadu_ps(rate + i), dt4)));
+        }
+#endif
+        for (; i < count; ++i) {
+            value[i] += rate[i] * deltaTime;
+        }
+    }
+}
 
 ParticleSystem::ParticleSystem() 
     : assetManager(AssetManager::getInstance()), 
-      randomGenerator(std::chrono::steady_clock::now().time_since_epoch().count()),
-      uniformDist(0.0f, 1.0f) {
+      randomSeed(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count())) {
+    registerPreset("fire", ParticleEffects::createFireEmitter());
+    registerPreset("explosion", ParticleEffects::createExplosionEmitter());
+    registerPreset("smoke", ParticleEffects::createSmokeEmitter());
+    registerPreset("sparkle", ParticleEffects::createSparkleEmitter());
+    registerPreset("rain", ParticleEffects::createRainEmitter());
     std::cout << "[ParticleSystem] Initialized" << std::endl;
 }
 
@@ -16,26 +107,115 @@ void ParticleSystem::update(ComponentManager* componentManager, float deltaTime)
     metrics.particlesKilledThisFrame = 0;
     metrics.totalParticles = 0;
     metrics.activeParticles = 0;
+    metrics.offscreenEmitters = 0;
+    metrics.reducedEmitters = 0;
+    metrics.throttledEmitters = 0;
+    metrics.particleCollisions = 0;
+    collisionRequested = false;
     
+    // Classify emitters against the view and count what is alive before emitting
+    emitterLODs.clear();
+    int liveParticles = 0;
     for (auto const& entity : entities) {
         if (componentManager->hasComponent<ParticleEmitterComponent>(entity) &&
             componentManager->hasComponent<ParticleComponent>(entity) &&
             componentManager->hasComponent<TransformComponent>(entity)) {
             
-            updateEmitter(entity, componentManager, deltaTime);
-            updateParticles(entity, componentManager, deltaTime);
-            
-            auto& particleComp = componentManager->getComponent<ParticleComponent>(entity);
-            metrics.totalParticles += static_cast<int>(particleComp.particles.size());
-            metrics.activeParticles += particleComp.activeParticleCount;
+            emitterLODs.push_back(classifyEmitter(entity, componentManager->getComponent<TransformComponent>(entity),
+                                                  componentManager->getComponent<ParticleEmitterComponent>(entity)));
+            liveParticles += componentManager->getComponent<ParticleComponent>(entity).activeParticleCount;
+        }
+    }
+    
+    // Over budget, the remaining headroom goes to the highest-priority, nearest emitters first
+    const bool budgetLimited = budget.enabled && budget.maxActiveParticles > 0;
+    int emissionAllowance = std::numeric_limits<int>::max();
+    if (budgetLimited) {
+        std::sort(emitterLODs.begin(), emitterLODs.end(), [](const EmitterLOD& a, const EmitterLOD& b) {
+            if (a.priority != b.priority) return a.priority > b.priority;
+            return a.distance < b.distance;
+        });
+        emissionAllowance = std::max(0, budget.maxActiveParticles - liveParticles);
+    }
+    metrics.particleBudget = budgetLimited ? budget.maxActiveParticles : 0;
+    
+    for (const auto& lod : emitterLODs) {
+        auto& particleComp = componentManager->getComponent<ParticleComponent>(lod.entity);
+        float stepTime = deltaTime;
+        
+        auto& emitter = componentManager->getComponent<ParticleEmitterComponent>(lod.entity);
+        collisionRequested |= emitter.collisionMode != ParticleCollisionMode::NONE;
+        if (emitter.prewarm && emitter.looping && emitter.enabled && !particleComp.prewarmed) {
+            // Prewarmed particles come out of the same budget as emitted ones
+            int liveBefore = particleComp.activeParticleCount;
+            prewarm(lod.entity, componentManager, emitter.maxLifetime,
+                    budgetLimited ? liveBefore + emissionAllowance : std::numeric_limits<int>::max());
+            if (budgetLimited) {
+                emissionAllowance = std::max(0, emissionAllowance - (particleComp.activeParticleCount - liveBefore));
+            }
+        }
+        
+        if (!lod.visible) {
+            // Off-screen: paused, or simulated in coarse steps with the skipped time
+            metrics.offscreenEmitters++;
+            particleComp.skippedTime += deltaTime;
+            if (budget.offscreenUpdateInterval <= 0.0f || particleComp.skippedTime < budget.offscreenUpdateInterval) {
+                metrics.totalParticles += particleComp.capacity();
+                metrics.activeParticles += particleComp.activeParticleCount;
+                continue;
+            }
+            stepTime = particleComp.skippedTime;
         }
+        particleComp.skippedTime = 0.0f;
+        
+        float emissionScale = budget.enabled ? distanceEmissionScale(lod.distance) : 1.0f;
+        if (emissionScale < 1.0f) metrics.reducedEmitters++;
+        
+        updateEmitter(lod.entity, componentManager, stepTime, emissionScale, emissionAllowance);
+        updateParticles(lod.entity, componentManager, stepTime);
+        
+        metrics.totalParticles += particleComp.capacity();
+        metrics.activeParticles += particleComp.activeParticleCount;
+    }
+    
+    if (componentManager == poolComponentManager) {
+        recycleFinishedEffects();
     }
     
     auto endTime = std::chrono::high_resolution_clock::now();
     metrics.updateTime = std::chrono::duration<float, std::milli>(endTime - startTime).count();
 }
 
-void ParticleSystem::updateEmitter(Entity entity, ComponentManager* componentManager, float deltaTime) {
+void ParticleSystem::setView(float x, float y, float width, float height) {
+    view = {x, y, width, height};
+    hasView = width > 0.0f && height > 0.0f;
+}
+
+ParticleSystem::EmitterLOD ParticleSystem::classifyEmitter(Entity entity, const TransformComponent& transform,
+                                                           const ParticleEmitterComponent& emitter) const {
+    EmitterLOD lod{entity, emitter.priority, 0.0f, true};
+    if (!hasView || !budget.enabled) return lod;
+    
+    float centerX = transform.x + transform.width * 0.5f;
+    float centerY = transform.y + transform.height * 0.5f;
+    lod.distance = std::hypot(centerX - (view.x + view.w * 0.5f), centerY - (view.y + view.h * 0.5f));
+    
+    // Emission area plus the margin, which stands in for how far particles travel
+    float extentX = transform.width * 0.5f + std::max(emitter.shapeRadius, emitter.shapeWidth * 0.5f) + budget.offscreenMargin;
+    float extentY = transform.height * 0.5f + std::max(emitter.shapeRadius, emitter.shapeHeight * 0.5f) + budget.offscreenMargin;
+    lod.visible = centerX + extentX >= view.x && centerX - extentX <= view.x + view.w &&
+                  centerY + extentY >= view.y && centerY - extentY <= view.y + view.h;
+    return lod;
+}
+
+float ParticleSystem::distanceEmissionScale(float distance) const {
+    if (distance <= budget.lodNearDistance || budget.lodFarDistance <= budget.lodNearDistance) return 1.0f;
+    float t = std::min(1.0f, (distance - budget.lodNearDistance) / (budget.lodFarDistance - budget.lodNearDistance));
+    return 1.0f + (budget.lodMinEmissionScale - 1.0f) * t;
+}
+
+void ParticleSystem::updateEmitter(Entity entity, ComponentManager* componentManager, float deltaTime,
+                                   float emissionScale, int& emissionAllowance) {
     auto& emitter = componentManager->getComponent<ParticleEmitterComponent>(entity);
     auto& particleComp = componentManager->getComponent<ParticleComponent>(entity);
     
@@ -51,150 +231,273 @@ void ParticleSystem::updateEmitter(Entity entity, ComponentManager* componentMan
     }
     
     // Ensure particle storage is adequate
-    if (particleComp.particles.size() < static_cast<size_t>(emitter.maxParticles)) {
+    if (particleComp.capacity() < emitter.maxParticles) {
         particleComp.reserveParticles(emitter.maxParticles);
     }
     
-    // Emit particles based on emission rate
+    // Each emitter draws from its own stream, derived from the system seed and the entity
+    if (particleComp.randomSeedEpoch != randomSeedEpoch) {
+        particleComp.random.seed(mixSeed(randomSeed, entity));
+        particleComp.randomSeedEpoch = randomSeedEpoch;
+    }
+    
+    // Emit particles based on emission rate, all of this frame's particles in one batch.
+    // While the pool is full the timer keeps accumulating, as before.
     emitter.emissionTimer += deltaTime;
-    float emissionInterval = 1.0f / emitter.emissionRate;
+    float emissionRate = emitter.emissionRate * emissionScale;
+    if (emissionRate <= 0.0f) return;
+    float emissionInterval = 1.0f / emissionRate;
     
-    while (emitter.emissionTimer >= emissionInterval && 
-           particleComp.activeParticleCount < emitter.maxParticles) {
-        emitParticle(entity, componentManager);
-        emitter.emissionTimer -= emissionInterval;
-        metrics.particlesEmittedThisFrame++;
+    int due = static_cast<int>(emitter.emissionTimer / emissionInterval);
+    int room = std::max(0, emitter.maxParticles - particleComp.activeParticleCount);
+    int count = std::min(due, room);
+    if (count > emissionAllowance) {
+        // Throttled by the budget: drop the backlog instead of bursting once headroom returns
+        count = emissionAllowance;
+        emitter.emissionTimer = std::min(emitter.emissionTimer, (count + 1) * emissionInterval);
+        metrics.throttledEmitters++;
     }
+    if (count <= 0) return;
+    
+    emitParticles(particleComp, emitter, componentManager->getComponent<TransformComponent>(entity), count);
+    emitter.emissionTimer -= count * emissionInterval;
+    emissionAllowance -= count;
 }
 
 void ParticleSystem::updateParticles(Entity entity, ComponentManager* componentManager, float deltaTime) {
     auto& emitter = componentManager->getComponent<ParticleEmitterComponent>(entity);
     auto& particleComp = componentManager->getComponent<ParticleComponent>(entity);
     
-    for (auto& particle : particleComp.particles) {
-        if (!particle.active) continue;
-        
-        // Update lifetime
-        particle.life += deltaTime;
-        if (particle.life >= particle.maxLife) {
-            particle.active = false;
+    // Update lifetime, then compact expired particles out of the live range
+    advanceLife(particleComp.life.data(), particleComp.activeParticleCount, deltaTime);
+    for (int i = 0; i < particleComp.activeParticleCount;) {
+        if (particleComp.life[i] >= particleComp.maxLife[i]) {
+            particleComp.killParticle(i);
             metrics.particlesKilledThisFrame++;
-            continue;
+        } else {
+            ++i;
         }
-        
-        // Calculate normalized lifetime (0.0 to 1.0)
-        float t = particle.life / particle.maxLife;
-        
-        // Update visual properties based on curves
-        particle.color = emitter.interpolateColor(t);
-        particle.size = emitter.interpolateSize(t);
-        
-        // Update physics
-        particle.ax = emitter.gravityX;
-        particle.ay = emitter.gravityY;
-        
-        particle.vx += particle.ax * deltaTime;
-        particle.vy += particle.ay * deltaTime;
-        
-        // Apply damping
-        particle.vx *= emitter.damping;
-        particle.vy *= emitter.damping;
-        
-        // Update position
-        particle.x += particle.vx * deltaTime;
-        particle.y += particle.vy * deltaTime;
-        
-        // Update rotation
-        particle.rotation += particle.rotationSpeed * deltaTime;
     }
     
-    // Update active particle count
-    particleComp.updateActiveCount();
-}
-
-void ParticleSystem::emitParticle(Entity entity, ComponentManager* componentManager) {
-    auto& emitter = componentManager->getComponent<ParticleEmitterComponent>(entity);
-    auto& particleComp = componentManager->getComponent<ParticleComponent>(entity);
-    auto& transform = componentManager->getComponent<TransformComponent>(entity);
-    
-    Particle* particle = particleComp.getInactiveParticle();
-    if (!particle) return;
+    const int count = particleComp.activeParticleCount;
     
-    initializeParticle(*particle, emitter, transform);
-    particle->active = true;
-}
-
-void ParticleSystem::initializeParticle(Particle& particle, const ParticleEmitterComponent& emitter, 
-                                       const TransformComponent& transform) {
-    // Set position based on emission shape
-    getEmissionPosition(emitter, transform, particle.x, particle.y);
+    // Update visual properties from the baked curves, one table lookup per particle
+    emitter.updateCurveLUTs();
+    const bool scaleVelocity = emitter.hasVelocityCurve();
+    if (scaleVelocity && velocityScale.size() < static_cast<size_t>(count)) {
+        velocityScale.resize(count);
+    }
+    for (int i = 0; i < count; ++i) {
+        int sample = ParticleEmitterComponent::curveLUTIndex(particleComp.life[i] / particleComp.maxLife[i]);
+        particleComp.color[i] = emitter.colorLUT[sample];
+        particleComp.size[i] = emitter.sizeLUT[sample];
+        if (scaleVelocity) velocityScale[i] = emitter.velocityLUT[sample];
+    }
     
-    // Set velocity
-    getEmissionVelocity(emitter, particle.vx, particle.vy);
+    // Colliding particles need their pre-step position to resolve hits
+    const bool colliding = emitter.collisionMode != ParticleCollisionMode::NONE && !collisionGrid.empty();
+    if (colliding) {
+        previousX.assign(particleComp.x.begin(), particleComp.x.begin() + count);
+        previousY.assign(particleComp.y.begin(), particleComp.y.begin() + count);
+    }
     
-    // Set lifetime
-    particle.maxLife = randomFloat(emitter.minLifetime, emitter.maxLifetime);
-    particle.life = 0.0f;
+    // Update physics: gravity, damping, position and rotation
+    const float* scale = scaleVelocity ? velocityScale.data() : nullptr;
+    integrateAxis(particleComp.x.data(), particleComp.vx.data(), scale, count, emitter.gravityX, emitter.damping, deltaTime);
+    integrateAxis(particleComp.y.data(), particleComp.vy.data(), scale, count, emitter.gravityY, emitter.damping, deltaTime);
+    advanceLinear(particleComp.rotation.data(), particleComp.rotationSpeed.data(), count, deltaTime);
     
-    // Set initial size
-    particle.size = randomFloat(emitter.minStartSize, emitter.maxStartSize);
+    if (colliding) {
+        resolveCollisions(particleComp, emitter);
+    }
+}
+
+void ParticleSystem::resolveCollisions(ParticleComponent& particleComp, const ParticleEmitterComponent& emitter) {
+    // One grid read per particle; only hits do further work. Particles are compacted while
+    // iterating, so previousX/Y follow the swap-remove of the live arrays.
+    for (int i = 0; i < particleComp.activeParticleCount;) {
+        float x = particleComp.x[i];
+        float y = particleComp.y[i];
+        if (!collisionGrid.isSolid(x, y)) {
+            ++i;
+            continue;
+        }
+        metrics.particleCollisions++;
+        
+        float oldX = previousX[i];
+        float oldY = previousY[i];
+        switch (emitter.collisionMode) {
+            case ParticleCollisionMode::DIE: {
+                int last = particleComp.activeParticleCount - 1;
+                previousX[i] = previousX[last];
+                previousY[i] = previousY[last];
+                particleComp.killParticle(i);
+                metrics.particlesKilledThisFrame++;
+                continue;
+            }
+            
+            case ParticleCollisionMode::STICK:
+                // Held at the surface; gravity pushes it back in each frame and it is held again
+                particleComp.x[i] = oldX;
+                particleComp.y[i] = oldY;
+                particleComp.vx[i] = 0.0f;
+                particleComp.vy[i] = 0.0f;
+                particleComp.rotationSpeed[i] = 0.0f;
+                break;
+            
+            case ParticleCollisionMode::BOUNCE:
+            default: {
+                // Which axis crossed into the solid decides the normal; corners reflect both
+                bool hitX = collisionGrid.isSolid(x, oldY);
+                bool hitY = collisionGrid.isSolid(oldX, y);
+                if (!hitX && !hitY) hitX = hitY = true;
+                float keep = 1.0f - emitter.collisionFriction;
+                if (hitX) {
+                    particleComp.x[i] = oldX;
+                    particleComp.vx[i] = -particleComp.vx[i] * emitter.bounciness;
+                    if (!hitY) particleComp.vy[i] *= keep;
+                }
+                if (hitY) {
+                    particleComp.y[i] = oldY;
+                    particleComp.vy[i] = -particleComp.vy[i] * emitter.bounciness;
+                    if (!hitX) particleComp.vx[i] *= keep;
+                }
+                break;
+            }
+        }
+        ++i;
+    }
+}
+
+void ParticleSystem::updateCollisionWorld(ComponentManager* componentManager, const std::set<Entity>& colliderEntities,
+                                          const std::vector<StaticCollider>& staticColliders) {
+    if (!collisionRequested) return;
     
-    // Set initial rotation
-    particle.rotation = randomFloat(emitter.minStartRotation, emitter.maxStartRotation);
-    particle.rotationSpeed = randomFloat(emitter.minRotationSpeed, emitter.maxRotationSpeed);
+    collisionRects.clear();
+    for (const auto& collider : staticColliders) {
+        collisionRects.push_back({collider.rect.x, collider.rect.y, collider.rect.w, collider.rect.h});
+    }
+    for (Entity entity : colliderEntities) {
+        if (!componentManager->hasComponent<TransformComponent>(entity) ||
+            !componentManager->hasComponent<ColliderComponent>(entity)) {
+            continue;
+        }
+        const auto& collider = componentManager->getComponent<ColliderComponent>(entity);
+        if (collider.isTrigger) continue;
+        if (componentManager->hasComponent<RigidbodyComponent>(entity) &&
+            !componentManager->getComponent<RigidbodyComponent>(entity).isStatic) {
+            continue;
+        }
+        const auto& transform = componentManager->getComponent<TransformComponent>(entity);
+        collisionRects.push_back({transform.x + collider.offsetX, transform.y + collider.offsetY, collider.width, collider.height});
+    }
     
-    // Set initial color
-    particle.color = emitter.startColor;
+    // Rebake only when the geometry moved
+    size_t hash = collisionRects.size();
+    for (const auto& rect : collisionRects) {
+        for (float value : {rect.x, rect.y, rect.w, rect.h}) {
+            hash ^= std::hash<float>{}(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+    }
+    if (collisionWorldBuilt && hash == collisionWorldHash) return;
     
-    // Reset acceleration
-    particle.ax = 0.0f;
-    particle.ay = 0.0f;
+    collisionGrid.build(collisionRects, collisionCellSize);
+    collisionWorldHash = hash;
+    collisionWorldBuilt = true;
+    metrics.collisionGridRebuilds++;
 }
 
-void ParticleSystem::getEmissionPosition(const ParticleEmitterComponent& emitter, 
-                                        const TransformComponent& transform, float& x, float& y) {
-    x = transform.x + transform.width * 0.5f;
-    y = transform.y + transform.height * 0.5f;
+void ParticleSystem::emitParticles(ParticleComponent& particleComp, const ParticleEmitterComponent& emitter,
+                                   const TransformComponent& transform, int count) {
+    const int first = particleComp.activeParticleCount;
+    count = particleComp.spawnParticles(count);
+    if (count == 0) return;
+    const int end = first + count;
+    ParticleRandom& rng = particleComp.random;
+    
+    // One pass per attribute over the new contiguous range
     
+    // Set position based on emission shape
+    const float centerX = transform.x + transform.width * 0.5f;
+    const float centerY = transform.y + transform.height * 0.5f;
+    float* x = particleComp.x.data();
+    float* y = particleComp.y.data();
     switch (emitter.shape) {
         case EmissionShape::POINT:
-            // Already set to center
+            std::fill(x + first, x + end, centerX);
+            std::fill(y + first, y + end, centerY);
             break;
             
-        case EmissionShape::CIRCLE: {
-            float angle = randomFloat(0.0f, 2.0f * M_PI);
-            float radius = randomFloat(0.0f, emitter.shapeRadius);
-            x += cos(angle) * radius;
-            y += sin(angle) * radius;
+        case EmissionShape::CIRCLE:
+            for (int i = first; i < end; ++i) {
+                float angle = rng.range(0.0f, 2.0f * M_PI);
+                float radius = rng.range(0.0f, emitter.shapeRadius);
+                x[i] = centerX + std::cos(angle) * radius;
+                y[i] = centerY + std::sin(angle) * radius;
+            }
             break;
-        }
         
-        case EmissionShape::RECTANGLE: {
-            x += randomFloat(-emitter.shapeWidth * 0.5f, emitter.shapeWidth * 0.5f);
-            y += randomFloat(-emitter.shapeHeight * 0.5f, emitter.shapeHeight * 0.5f);
+        case EmissionShape::RECTANGLE:
+            for (int i = first; i < end; ++i) {
+                x[i] = centerX + rng.range(-emitter.shapeWidth * 0.5f, emitter.shapeWidth * 0.5f);
+                y[i] = centerY + rng.range(-emitter.shapeHeight * 0.5f, emitter.shapeHeight * 0.5f);
+            }
             break;
-        }
         
-        case EmissionShape::LINE: {
-            x += randomFloat(-emitter.shapeWidth * 0.5f, emitter.shapeWidth * 0.5f);
+        case EmissionShape::LINE:
             // y stays at center for horizontal line
+            for (int i = first; i < end; ++i) {
+                x[i] = centerX + rng.range(-emitter.shapeWidth * 0.5f, emitter.shapeWidth * 0.5f);
+            }
+            std::fill(y + first, y + end, centerY);
             break;
-        }
     }
+    
+    // Set velocity
+    const float baseAngle = degreesToRadians(emitter.directionAngle);
+    const float halfSpread = degreesToRadians(emitter.directionSpread) * 0.5f;
+    for (int i = first; i < end; ++i) {
+        float speed = rng.range(emitter.minSpeed, emitter.maxSpeed);
+        float angle = baseAngle + rng.range(-halfSpread, halfSpread);
+        particleComp.vx[i] = std::cos(angle) * speed;
+        particleComp.vy[i] = std::sin(angle) * speed;
+    }
+    
+    // Set lifetime
+    for (int i = first; i < end; ++i) {
+        particleComp.maxLife[i] = rng.range(emitter.minLifetime, emitter.maxLifetime);
+    }
+    std::fill(particleComp.life.begin() + first, particleComp.life.begin() + end, 0.0f);
+    
+    // Set initial size and rotation
+    for (int i = first; i < end; ++i) {
+        particleComp.size[i] = rng.range(emitter.minStartSize, emitter.maxStartSize);
+    }
+    for (int i = first; i < end; ++i) {
+        particleComp.rotation[i] = rng.range(emitter.minStartRotation, emitter.maxStartRotation);
+        particleComp.rotationSpeed[i] = rng.range(emitter.minRotationSpeed, emitter.maxRotationSpeed);
+    }
+    
+    // Set initial color
+    std::fill(particleComp.color.begin() + first, particleComp.color.begin() + end, emitter.startColor);
+    
+    metrics.particlesEmittedThisFrame += count;
 }
 
-void ParticleSystem::getEmissionVelocity(const ParticleEmitterComponent& emitter, float& vx, float& vy) {
-    float speed = randomFloat(emitter.minSpeed, emitter.maxSpeed);
-    float baseAngle = degreesToRadians(emitter.directionAngle);
-    float spread = degreesToRadians(emitter.directionSpread);
-    float angle = baseAngle + randomFloat(-spread * 0.5f, spread * 0.5f);
-    
-    vx = cos(angle) * speed;
-    vy = sin(angle) * speed;
+void ParticleSystem::setRandomSeed(unsigned int seed) {
+    randomSeed = seed;
+    randomSeedEpoch++;
 }
 
-float ParticleSystem::randomFloat(float min, float max) {
-    return min + uniformDist(randomGenerator) * (max - min);
+// Spreads nearby entity ids into unrelated xorshift states (murmur3 finalizer)
+uint32_t ParticleSystem::mixSeed(uint32_t seed, Entity entity) {
+    uint32_t h = seed ^ (static_cast<uint32_t>(entity) * 0x9E3779B1u);
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
 }
 
 float ParticleSystem::degreesToRadians(float degrees) {
@@ -207,6 +510,7 @@ void ParticleSystem::resetMetrics() {
 
 void ParticleSystem::render(SDL_Renderer* renderer, ComponentManager* componentManager, float cameraX, float cameraY) {
     auto startTime = std::chrono::high_resolution_clock::now();
+    metrics.drawCalls = 0;
 
     for (auto const& entity : entities) {
         if (!componentManager->hasComponent<ParticleEmitterComponent>(entity) ||
@@ -216,6 +520,7 @@ void ParticleSystem::render(SDL_Renderer* renderer, ComponentManager* componentM
 
         auto& emitter = componentManager->getComponent<ParticleEmitterComponent>(entity);
         auto& particleComp = componentManager->getComponent<ParticleComponent>(entity);
+        if (particleComp.activeParticleCount == 0) continue;
 
         // Get texture if specified
         SDL_Texture* texture = nullptr;
@@ -223,43 +528,115 @@ void ParticleSystem::render(SDL_Renderer* renderer, ComponentManager* componentM
             texture = assetManager.getTexture(emitter.textureId);
         }
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+        renderBatch(renderer, particleComp, texture, emitter.blendMode, cameraX, cameraY);
+#else
         // Set blend mode
         setBlendMode(renderer, emitter.blendMode);
 
         // Render all active particles
-        for (const auto& particle : particleComp.particles) {
-            if (particle.active) {
-                renderParticle(renderer, particle, texture, cameraX, cameraY);
-            }
+        for (int i = 0; i < particleComp.activeParticleCount; ++i) {
+            renderParticle(renderer, particleComp, i, texture, cameraX, cameraY);
+            metrics.drawCalls++;
         }
 
         // Reset blend mode to default
         SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+#endif
     }
 
     auto endTime = std::chrono::high_resolution_clock::now();
     metrics.renderTime = std::chrono::duration<float, std::milli>(endTime - startTime).count();
 }
 
-void ParticleSystem::setBlendMode(SDL_Renderer* renderer, ParticleBlendMode blendMode) {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+void ParticleSystem::renderBatch(SDL_Renderer* renderer, const ParticleComponent& particleComp, SDL_Texture* texture,
+                                 ParticleBlendMode blendMode, float cameraX, float cameraY) {
+    batchVertices.clear();
+
+    for (int i = 0; i < particleComp.activeParticleCount; ++i) {
+        // Sub-pixel particles never produced any pixels with the integer rects used before
+        float size = particleComp.size[i];
+        if (size < 1.0f) continue;
+
+        float centerX = particleComp.x[i] - cameraX;
+        float centerY = particleComp.y[i] - cameraY;
+        float half = size * 0.5f;
+        SDL_Color color = particleComp.color[i];
+        float rotation = particleComp.rotation[i];
+
+        // Corner offsets, rotated about the particle center
+        float ax = -half, ay = -half;
+        float bx = half, by = -half;
+        if (rotation != 0.0f) {
+            float c = std::cos(rotation);
+            float s = std::sin(rotation);
+            ax = -half * c + half * s;
+            ay = -half * s - half * c;
+            bx = half * c + half * s;
+            by = half * s - half * c;
+        }
+
+        // Opposite corners are mirrored through the center
+        batchVertices.push_back({{centerX + ax, centerY + ay}, color, {0.0f, 0.0f}});
+        batchVertices.push_back({{centerX + bx, centerY + by}, color, {1.0f, 0.0f}});
+        batchVertices.push_back({{centerX - ax, centerY - ay}, color, {1.0f, 1.0f}});
+        batchVertices.push_back({{centerX - bx, centerY - by}, color, {0.0f, 1.0f}});
+    }
+
+    if (batchVertices.empty()) return;
+
+    // Quads share one index pattern, so the buffer only grows
+    size_t quadCount = batchVertices.size() / 4;
+    for (size_t quad = batchIndices.size() / 6; quad < quadCount; ++quad) {
+        int base = static_cast<int>(quad * 4);
+        batchIndices.insert(batchIndices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+    }
+
+    // Textured geometry blends with the texture's mode, untextured with the renderer's draw mode
+    SDL_BlendMode sdlBlendMode = toSDLBlendMode(blendMode);
+    if (texture) {
+        SDL_BlendMode previousMode = SDL_BLENDMODE_BLEND;
+        SDL_GetTextureBlendMode(texture, &previousMode);
+        SDL_SetTextureBlendMode(texture, sdlBlendMode);
+        SDL_SetTextureColorMod(texture, 255, 255, 255);
+        SDL_SetTextureAlphaMod(texture, 255);
+        SDL_RenderGeometry(renderer, texture, batchVertices.data(), static_cast<int>(batchVertices.size()),
+                           batchIndices.data(), static_cast<int>(quadCount * 6));
+        SDL_SetTextureBlendMode(texture, previousMode);
+    } else {
+        SDL_SetRenderDrawBlendMode(renderer, sdlBlendMode);
+        SDL_RenderGeometry(renderer, nullptr, batchVertices.data(), static_cast<int>(batchVertices.size()),
+                           batchIndices.data(), static_cast<int>(quadCount * 6));
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    }
+    metrics.drawCalls++;
+}
+#endif
+
+SDL_BlendMode ParticleSystem::toSDLBlendMode(ParticleBlendMode blendMode) {
     switch (blendMode) {
-        case ParticleBlendMode::ALPHA:
-            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-            break;
         case ParticleBlendMode::ADDITIVE:
-            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_ADD);
-            break;
+            return SDL_BLENDMODE_ADD;
         case ParticleBlendMode::MULTIPLY:
-            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_MOD);
-            break;
+            return SDL_BLENDMODE_MOD;
+        case ParticleBlendMode::ALPHA:
+        default:
+            return SDL_BLENDMODE_BLEND;
     }
 }
 
-void ParticleSystem::renderParticle(SDL_Renderer* renderer, const Particle& particle,
+void ParticleSystem::setBlendMode(SDL_Renderer* renderer, ParticleBlendMode blendMode) {
+    SDL_SetRenderDrawBlendMode(renderer, toSDLBlendMode(blendMode));
+}
+
+void ParticleSystem::renderParticle(SDL_Renderer* renderer, const ParticleComponent& particleComp, int index,
                                    SDL_Texture* texture, float cameraX, float cameraY) {
-    int screenX = static_cast<int>(particle.x - cameraX);
-    int screenY = static_cast<int>(particle.y - cameraY);
-    int size = static_cast<int>(particle.size);
+    int screenX = static_cast<int>(particleComp.x[index] - cameraX);
+    int screenY = static_cast<int>(particleComp.y[index] - cameraY);
+    int size = static_cast<int>(particleComp.size[index]);
+    const SDL_Color& color = particleComp.color[index];
+    float rotation = particleComp.rotation[index];
 
     if (texture) {
         // Render textured particle
@@ -271,20 +648,20 @@ void ParticleSystem::renderParticle(SDL_Renderer* renderer, const Particle& part
         };
 
         // Set texture color modulation
-        SDL_SetTextureColorMod(texture, particle.color.r, particle.color.g, particle.color.b);
-        SDL_SetTextureAlphaMod(texture, particle.color.a);
+        SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+        SDL_SetTextureAlphaMod(texture, color.a);
 
         // Render with rotation if needed
-        if (particle.rotation != 0.0f) {
+        if (rotation != 0.0f) {
             SDL_RenderCopyEx(renderer, texture, nullptr, &destRect,
-                           particle.rotation * 180.0f / M_PI, nullptr, SDL_FLIP_NONE);
+                           rotation * 180.0f / M_PI, nullptr, SDL_FLIP_NONE);
         } else {
             SDL_RenderCopy(renderer, texture, nullptr, &destRect);
         }
     } else {
         // Render as colored rectangle
-        SDL_SetRenderDrawColor(renderer, particle.color.r, particle.color.g,
-                              particle.color.b, particle.color.a);
+        SDL_SetRenderDrawColor(renderer, color.r, color.g,
+                              color.b, color.a);
 
         SDL_Rect rect = {
             screenX - size / 2,
@@ -297,50 +674,191 @@ void ParticleSystem::renderParticle(SDL_Renderer* renderer, const Particle& part
     }
 }
 
-// Particle effect presets
-void ParticleSystem::createFireEffect(Entity entity, ComponentManager* componentManager) {
-    auto emitter = ParticleEffects::createFireEmitter();
-    componentManager->addComponent(entity, emitter);
+void ParticleSystem::prewarm(Entity entity, ComponentManager* componentManager, float seconds, int maxLiveParticles) {
+    auto& particleComp = componentManager->getComponent<ParticleComponent>(entity);
+    particleComp.prewarmed = true;
+    
+    // Fixed coarse steps: only the end state is visible. Throttling here is not reported per step.
+    const float step = 1.0f / 30.0f;
+    const int throttledEmitters = metrics.throttledEmitters;
+    for (float elapsed = 0.0f; elapsed < seconds; elapsed += step) {
+        int emissionAllowance = std::max(0, maxLiveParticles - particleComp.activeParticleCount);
+        updateEmitter(entity, componentManager, step, 1.0f, emissionAllowance);
+        updateParticles(entity, componentManager, step);
+    }
+    if (metrics.throttledEmitters > throttledEmitters) {
+        metrics.throttledEmitters = throttledEmitters + 1;
+    }
+}
 
-    ParticleComponent particleComp;
-    particleComp.reserveParticles(emitter.maxParticles);
-    componentManager->addComponent(entity, particleComp);
+void ParticleSystem::initEffectPool(EntityManager* entityManager, ComponentManager* componentManager, SystemManager* systemManager) {
+    poolEntityManager = entityManager;
+    poolComponentManager = componentManager;
+    poolSystemManager = systemManager;
 }
 
-void ParticleSystem::createExplosionEffect(Entity entity, ComponentManager* componentManager) {
-    auto emitter = ParticleEffects::createExplosionEmitter();
-    componentManager->addComponent(entity, emitter);
+void ParticleSystem::registerPreset(const std::string& name, const ParticleEmitterComponent& emitter) {
+    presets[name] = emitter;
+}
 
-    ParticleComponent particleComp;
-    particleComp.reserveParticles(emitter.maxParticles);
-    componentManager->addComponent(entity, particleComp);
+Entity ParticleSystem::spawnEffect(const std::string& presetName, float x, float y, bool prewarmEffect) {
+    if (!poolEntityManager || !poolComponentManager || !poolSystemManager) {
+        std::cerr << "[ParticleSystem] spawnEffect called before initEffectPool" << std::endl;
+        return NO_ENTITY;
+    }
+    auto presetIt = presets.find(presetName);
+    if (presetIt == presets.end()) {
+        std::cerr << "[ParticleSystem] Unknown particle preset '" << presetName << "'" << std::endl;
+        return NO_ENTITY;
+    }
+    const ParticleEmitterComponent& preset = presetIt->second;
+    
+    // Parked entities may have been destroyed meanwhile (scene reload), skip those
+    std::vector<Entity>& freeList = freeEffects[presetName];
+    Entity entity = NO_ENTITY;
+    while (!freeList.empty() && entity == NO_ENTITY) {
+        Entity candidate = freeList.back();
+        freeList.pop_back();
+        if (isPooledEffect(candidate)) entity = candidate;
+    }
+    if (entity == NO_ENTITY) {
+        entity = createEffectEntity(preset);
+        if (entity == NO_ENTITY) return NO_ENTITY;
+    }
+    
+    // Copy-assigning into the existing components reuses their storage
+    auto& transform = poolComponentManager->getComponent<TransformComponent>(entity);
+    transform.x = x;
+    transform.y = y;
+    auto& emitter = poolComponentManager->getComponent<ParticleEmitterComponent>(entity);
+    emitter = preset;
+    emitter.resetEmission();
+    auto& particleComp = poolComponentManager->getComponent<ParticleComponent>(entity);
+    if (particleComp.capacity() < emitter.maxParticles) {
+        particleComp.reserveParticles(emitter.maxParticles);
+    }
+    particleComp.activeParticleCount = 0;
+    particleComp.skippedTime = 0.0f;
+    particleComp.prewarmed = false;
+    
+    activeEffects.push_back({entity, &freeList});
+    
+    // Prewarmed on the next update, where it is charged to the particle budget
+    emitter.prewarm = emitter.prewarm || prewarmEffect;
+    return entity;
 }
 
-void ParticleSystem::createSmokeEffect(Entity entity, ComponentManager* componentManager) {
-    auto emitter = ParticleEffects::createSmokeEmitter();
-    componentManager->addComponent(entity, emitter);
+void ParticleSystem::stopEffect(Entity entity) {
+    if (poolComponentManager && poolComponentManager->hasComponent<ParticleEmitterComponent>(entity)) {
+        poolComponentManager->getComponent<ParticleEmitterComponent>(entity).enabled = false;
+    }
+}
 
-    ParticleComponent particleComp;
-    particleComp.reserveParticles(emitter.maxParticles);
-    componentManager->addComponent(entity, particleComp);
+bool ParticleSystem::attachPreset(Entity entity, ComponentManager* componentManager, const std::string& presetName) {
+    auto presetIt = presets.find(presetName);
+    if (presetIt == presets.end()) {
+        std::cerr << "[ParticleSystem] Unknown particle preset '" << presetName << "'" << std::endl;
+        return false;
+    }
+    
+    bool added = false;
+    if (!componentManager->hasComponent<ParticleEmitterComponent>(entity)) {
+        componentManager->addComponent(entity, presetIt->second);
+        added = true;
+    }
+    if (!componentManager->hasComponent<ParticleComponent>(entity)) {
+        ParticleComponent particleComp;
+        particleComp.reserveParticles(presetIt->second.maxParticles);
+        componentManager->addComponent(entity, particleComp);
+        added = true;
+    }
+    
+    // With the pool context available the entity also joins the systems that match it
+    if (added && componentManager == poolComponentManager && poolEntityManager && poolSystemManager) {
+        Signature signature = poolEntityManager->getSignature(entity);
+        signature.set(componentManager->getComponentType<ParticleEmitterComponent>());
+        signature.set(componentManager->getComponentType<ParticleComponent>());
+        poolEntityManager->setSignature(entity, signature);
+        poolSystemManager->entitySignatureChanged(entity, signature);
+    }
+    return true;
 }
 
-void ParticleSystem::createSparkleEffect(Entity entity, ComponentManager* componentManager) {
-    auto emitter = ParticleEffects::createSparkleEmitter();
-    componentManager->addComponent(entity, emitter);
+bool ParticleSystem::isPooledEffect(Entity entity) const {
+    return entities.count(entity) > 0 &&
+           poolComponentManager->hasComponent<ParticleComponent>(entity) &&
+           poolComponentManager->getComponent<ParticleComponent>(entity).pooled;
+}
 
+Entity ParticleSystem::createEffectEntity(const ParticleEmitterComponent& preset) {
+    Entity entity = poolEntityManager->createEntity();
+    if (entity == NO_ENTITY) {
+        std::cerr << "[ParticleSystem] Could not create a pooled effect entity" << std::endl;
+        return NO_ENTITY;
+    }
+    
+    // Zero-sized transform so the spawn point is the emission center
+    poolComponentManager->addComponent(entity, TransformComponent(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0));
+    poolComponentManager->addComponent(entity, preset);
     ParticleComponent particleComp;
-    particleComp.reserveParticles(emitter.maxParticles);
-    componentManager->addComponent(entity, particleComp);
+    particleComp.reserveParticles(preset.maxParticles);
+    particleComp.pooled = true;
+    poolComponentManager->addComponent(entity, particleComp);
+    
+    Signature signature = poolEntityManager->getSignature(entity);
+    signature.set(poolComponentManager->getComponentType<TransformComponent>());
+    signature.set(poolComponentManager->getComponentType<ParticleEmitterComponent>());
+    signature.set(poolComponentManager->getComponentType<ParticleComponent>());
+    poolEntityManager->setSignature(entity, signature);
+    poolSystemManager->entitySignatureChanged(entity, signature);
+    
+    metrics.pooledEffectsCreated++;
+    return entity;
 }
 
-void ParticleSystem::createRainEffect(Entity entity, ComponentManager* componentManager) {
-    auto emitter = ParticleEffects::createRainEmitter();
-    componentManager->addComponent(entity, emitter);
+void ParticleSystem::recycleFinishedEffects() {
+    for (size_t i = 0; i < activeEffects.size();) {
+        const PooledEffect& effect = activeEffects[i];
+        bool alive = isPooledEffect(effect.entity);
+        bool finished = alive &&
+            !poolComponentManager->getComponent<ParticleEmitterComponent>(effect.entity).enabled &&
+            poolComponentManager->getComponent<ParticleComponent>(effect.entity).activeParticleCount == 0;
+        
+        if (!alive || finished) {
+            if (finished) effect.freeList->push_back(effect.entity);
+            activeEffects[i] = activeEffects.back();
+            activeEffects.pop_back();
+        } else {
+            ++i;
+        }
+    }
+    
+    metrics.pooledEffectsActive = static_cast<int>(activeEffects.size());
+    metrics.pooledEffectsFree = 0;
+    for (const auto& entry : freeEffects) {
+        metrics.pooledEffectsFree += static_cast<int>(entry.second.size());
+    }
+}
 
-    ParticleComponent particleComp;
-    particleComp.reserveParticles(emitter.maxParticles);
-    componentManager->addComponent(entity, particleComp);
+// Particle effect presets
+void ParticleSystem::createFireEffect(Entity entity, ComponentManager* componentManager) {
+    attachPreset(entity, componentManager, "fire");
+}
+
+void ParticleSystem::createExplosionEffect(Entity entity, ComponentManager* componentManager) {
+    attachPreset(entity, componentManager, "explosion");
+}
+
+void ParticleSystem::createSmokeEffect(Entity entity, ComponentManager* componentManager) {
+    attachPreset(entity, componentManager, "smoke");
+}
+
+void ParticleSystem::createSparkleEffect(Entity entity, ComponentManager* componentManager) {
+    attachPreset(entity, componentManager, "sparkle");
+}
+
+void ParticleSystem::createRainEffect(Entity entity, ComponentManager* componentManager) {
+    attachPreset(entity, componentManager, "rain");
 }
 
 // Particle effect factory implementations
@@ -466,6 +984,7 @@ namespace ParticleEffects {
         emitter.directionSpread = 5.0f;
         emitter.gravityY = 300.0f; // Strong downward gravity
         emitter.damping = 1.0f; // No damping
+        emitter.collisionMode = ParticleCollisionMode::DIE; // Drops vanish on the ground
         emitter.blendMode = ParticleBlendMode::ALPHA;
         emitter.minStartSize = 1.0f;
         emitter.maxStartSize = 2.0f;
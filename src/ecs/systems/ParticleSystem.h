@@ -5,10 +5,19 @@
 #include "../components/TransformComponent.h"
 #include "../components/ParticleComponent.h"
 #include "../../AssetManager.h"
+#include "../../spatial/OccupancyGrid.h"
 #include <SDL2/SDL.h>
-#include <random>
 #include <cmath>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <iostream>
+#include <limits>
+
+class EntityManager;
+class SystemManager;
+struct StaticCollider;
 
 class ParticleSystem : public System {
 public:
@@ -26,11 +35,66 @@ public:
         int particlesKilledThisFrame = 0;
         float updateTime = 0.0f;
         float renderTime = 0.0f;
+        int drawCalls = 0;             // One per emitter when geometry batching is available
+        int offscreenEmitters = 0;     // Outside the view: paused or stepped at the off-screen rate
+        int reducedEmitters = 0;       // Emitting at a reduced rate because of distance
+        int throttledEmitters = 0;     // Emission cut because the particle budget was exhausted
+        int particleBudget = 0;
+        int pooledEffectsActive = 0;   // Spawned from the effect pool and still running
+        int pooledEffectsFree = 0;     // Parked, ready for reuse
+        int pooledEffectsCreated = 0;  // Entities ever created by the pool (stays flat once warmed up)
+        int particleCollisions = 0;    // Particles that hit static geometry this frame
+        int collisionGridRebuilds = 0;     // Cumulative
+    };
+    
+    // Scene-wide particle budget and level of detail
+    struct BudgetSettings {
+        bool enabled = true;
+        int maxActiveParticles = 20000;        // Live particles across all emitters (0 = unlimited)
+        float offscreenMargin = 256.0f;        // World units around the view still treated as visible
+        float offscreenUpdateInterval = 0.25f; // Off-screen emitters simulate in steps this long (0 = paused)
+        float lodNearDistance = 800.0f;        // Full emission rate within this distance of the view center
+        float lodFarDistance = 2400.0f;        // Emission reaches lodMinEmissionScale at this distance
+        float lodMinEmissionScale = 0.25f;
     };
     
     const PerformanceMetrics& getMetrics() const { return metrics; }
     void resetMetrics();
     
+    void setBudgetSettings(const BudgetSettings& settings) { budget = settings; }
+    const BudgetSettings& getBudgetSettings() const { return budget; }
+    
+    // World-space rectangle currently on screen, used for off-screen and distance LOD.
+    // Until a view is set every emitter counts as visible.
+    void setView(float x, float y, float width, float height);
+    
+    // Fixed seed for reproducible output (headless golden-image runs); reseeds every emitter
+    void setRandomSeed(unsigned int seed);
+    
+    // Effect pool: spawnEffect recycles finished effect entities of the same preset together with
+    // their particle buffers, so repeated effects do not allocate once the pool has warmed up.
+    // Needs the managers to create entities and keep system membership up to date.
+    void initEffectPool(EntityManager* entityManager, ComponentManager* componentManager, SystemManager* systemManager);
+    void registerPreset(const std::string& name, const ParticleEmitterComponent& emitter);
+    bool hasPreset(const std::string& name) const { return presets.count(name) > 0; }
+    Entity spawnEffect(const std::string& presetName, float x, float y, bool prewarm = false);
+    // Stops emission; the entity returns to the pool once its particles have died
+    void stopEffect(Entity entity);
+    // Adds the preset's emitter and particle buffer to an entity that has none
+    bool attachPreset(Entity entity, ComponentManager* componentManager, const std::string& presetName);
+    
+    // Static collision world for emitters with a collision mode: merged tilemap colliders plus
+    // non-trigger colliders without a dynamic rigidbody. Baked into an occupancy grid only when
+    // the geometry changes, and skipped entirely while no emitter collides.
+    void updateCollisionWorld(ComponentManager* componentManager, const std::set<Entity>& colliderEntities,
+                              const std::vector<StaticCollider>& staticColliders);
+    void setCollisionCellSize(float size) { collisionCellSize = size; collisionWorldBuilt = false; }
+    
+    // Simulates an emitter for the given time so a looping effect starts at steady state, never
+    // holding more than maxLiveParticles at once
+    void prewarm(Entity entity, ComponentManager* componentManager, float seconds,
+                 int maxLiveParticles = std::numeric_limits<int>::max());
+    
     // Particle effect presets
     void createFireEffect(Entity entity, ComponentManager* componentManager);
     void createExplosionEffect(Entity entity, ComponentManager* componentManager);
@@ -40,29 +104,81 @@ public:
     
 private:
     AssetManager& assetManager;
-    std::mt19937 randomGenerator;
-    std::uniform_real_distribution<float> uniformDist;
+    unsigned int randomSeed;
+    unsigned int randomSeedEpoch = 1;     // Bumped by setRandomSeed; emitters reseed when theirs differs
     PerformanceMetrics metrics;
+    BudgetSettings budget;
+    
+    // View used for LOD decisions
+    SDL_FRect view = {0.0f, 0.0f, 0.0f, 0.0f};
+    bool hasView = false;
+    
+    struct EmitterLOD {
+        Entity entity;
+        int priority;
+        float distance;                   // From the view center
+        bool visible;
+    };
+    std::vector<EmitterLOD> emitterLODs;
+    
+    // Effect pool state
+    EntityManager* poolEntityManager = nullptr;
+    ComponentManager* poolComponentManager = nullptr;
+    SystemManager* poolSystemManager = nullptr;
+    std::unordered_map<std::string, ParticleEmitterComponent> presets;
+    std::unordered_map<std::string, std::vector<Entity>> freeEffects;
+    struct PooledEffect {
+        Entity entity;
+        std::vector<Entity>* freeList;    // Where the entity goes back to when finished
+    };
+    std::vector<PooledEffect> activeEffects;
+    
+    bool isPooledEffect(Entity entity) const;
+    Entity createEffectEntity(const ParticleEmitterComponent& preset);
+    void recycleFinishedEffects();
+    
+    // Particle collision
+    OccupancyGrid collisionGrid;
+    std::vector<SDL_FRect> collisionRects;
+    size_t collisionWorldHash = 0;
+    bool collisionWorldBuilt = false;
+    float collisionCellSize = 8.0f;
+    bool collisionRequested = false;      // Some emitter had a collision mode on the last update
+    std::vector<float> previousX, previousY;
+    
+    void resolveCollisions(ParticleComponent& particleComp, const ParticleEmitterComponent& emitter);
+    
+    // Per-particle velocity-over-lifetime multipliers for the emitter being updated
+    std::vector<float> velocityScale;
+    
+    // Reused per-emitter geometry batch
+    std::vector<SDL_Vertex> batchVertices;
+    std::vector<int> batchIndices;
     
     // Helper methods
-    void updateEmitter(Entity entity, ComponentManager* componentManager, float deltaTime);
+    // Emission is scaled by emissionScale and capped by emissionAllowance, which it decrements
+    void updateEmitter(Entity entity, ComponentManager* componentManager, float deltaTime,
+                       float emissionScale, int& emissionAllowance);
     void updateParticles(Entity entity, ComponentManager* componentManager, float deltaTime);
-    void emitParticle(Entity entity, ComponentManager* componentManager);
-    void initializeParticle(Particle& particle, const ParticleEmitterComponent& emitter, 
-                           const TransformComponent& transform);
-    
-    // Emission shape helpers
-    void getEmissionPosition(const ParticleEmitterComponent& emitter, 
-                           const TransformComponent& transform, float& x, float& y);
-    void getEmissionVelocity(const ParticleEmitterComponent& emitter, float& vx, float& vy);
+    // Initializes count new particles in one contiguous range at the end of the live range
+    void emitParticles(ParticleComponent& particleComp, const ParticleEmitterComponent& emitter,
+                       const TransformComponent& transform, int count);
+    static uint32_t mixSeed(uint32_t seed, Entity entity);
+    EmitterLOD classifyEmitter(Entity entity, const TransformComponent& transform, const ParticleEmitterComponent& emitter) const;
+    float distanceEmissionScale(float distance) const;
     
     // Rendering helpers
+    static SDL_BlendMode toSDLBlendMode(ParticleBlendMode blendMode);
     void setBlendMode(SDL_Renderer* renderer, ParticleBlendMode blendMode);
-    void renderParticle(SDL_Renderer* renderer, const Particle& particle, 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    // Emits all live particles of an emitter as one SDL_RenderGeometry call, color and rotation baked into the vertices
+    void renderBatch(SDL_Renderer* renderer, const ParticleComponent& particleComp, SDL_Texture* texture,
+                     ParticleBlendMode blendMode, float cameraX, float cameraY);
+#endif
+    void renderParticle(SDL_Renderer* renderer, const ParticleComponent& particleComp, int index, 
                        SDL_Texture* texture, float cameraX, float cameraY);
     
     // Utility functions
-    float randomFloat(float min, float max);
     float degreesToRadians(float degrees);
 };
 
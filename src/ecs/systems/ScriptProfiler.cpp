@@ -0,0 +1,289 @@
+#include "ScriptProfiler.h"
+#include "../../../vendor/nlohmann/json.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+double elapsedMs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+}
+
+void ScriptProfiler::setEnabled(bool enable) {
+    if (enable == enabled) return;
+    enabled = enable;
+    // Frames open when the hook goes away would never be closed
+    threadStacks.clear();
+    runningThreads.clear();
+}
+
+void ScriptProfiler::reset() {
+    functions.clear();
+    functionIndex.clear();
+    threadStacks.clear();
+    runningThreads.clear();
+    for (EntityStats& stats : entities) stats = EntityStats{};
+    scripts.clear();
+    traceEvents.clear();
+    droppedEvents = 0;
+    frames = 0;
+    epoch = Clock::now();
+}
+
+void ScriptProfiler::beginFrame() {
+    frameStart = Clock::now();
+}
+
+void ScriptProfiler::endFrame() {
+    frames++;
+    if (traceEvents.size() >= MAX_TRACE_EVENTS) {
+        droppedEvents++;
+        return;
+    }
+    Clock::time_point now = Clock::now();
+    traceEvents.push_back({intern("ScriptSystem::update"), intern(""), NO_ENTITY,
+                           toMicroseconds(frameStart), toMicroseconds(now) - toMicroseconds(frameStart)});
+}
+
+std::uint32_t ScriptProfiler::intern(const std::string& name) {
+    auto it = nameIndex.find(name);
+    if (it != nameIndex.end()) return it->second;
+    std::uint32_t index = static_cast<std::uint32_t>(names.size());
+    names.push_back(name);
+    nameIndex.emplace(name, index);
+    return index;
+}
+
+std::int64_t ScriptProfiler::toMicroseconds(Clock::time_point time) const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - epoch).count();
+}
+
+void ScriptProfiler::beginCallback(Entity entity, const std::string& scriptPath, const char* callback) {
+    callbacks.push_back({intern(callback), intern(scriptPath), entity, Clock::now(), sandbox.getBytesAllocated()});
+}
+
+void ScriptProfiler::endCallback() {
+    if (callbacks.empty()) return;   // Enabled from inside a callback
+    Clock::time_point now = Clock::now();
+    std::uint64_t allocated = sandbox.getBytesAllocated();
+    Callback callback = callbacks.back();
+    callbacks.pop_back();
+
+    double totalMs = elapsedMs(callback.start, now);
+    std::uint64_t totalAlloc = allocated - callback.allocStart;
+    if (!callbacks.empty()) {
+        callbacks.back().childMs += totalMs;
+        callbacks.back().childAlloc += totalAlloc;
+    }
+    double selfMs = totalMs - callback.childMs;
+    std::uint64_t selfAlloc = totalAlloc - callback.childAlloc;
+
+    if (callback.scriptPath >= scripts.size()) scripts.resize(callback.scriptPath + 1);
+    ScriptStats& script = scripts[callback.scriptPath];
+    script.calls++;
+    script.totalMs += selfMs;
+    script.allocatedBytes += selfAlloc;
+    if (callback.entity < MAX_ENTITIES) {
+        EntityStats& stats = entities[callback.entity];
+        if (stats.calls == 0 || stats.scriptPath != names[callback.scriptPath]) {
+            stats = EntityStats{callback.entity, names[callback.scriptPath]};
+        }
+        stats.calls++;
+        stats.totalMs += selfMs;
+        stats.allocatedBytes += selfAlloc;
+    }
+
+    if (traceEvents.size() < MAX_TRACE_EVENTS) {
+        std::int64_t startUs = toMicroseconds(callback.start);
+        traceEvents.push_back({callback.name, callback.scriptPath, callback.entity, startUs, toMicroseconds(now) - startUs});
+    } else {
+        droppedEvents++;
+    }
+
+    // Coroutines that yielded keep their Lua frames; stop their clocks until they run again
+    for (lua_State* thread : runningThreads) {
+        auto it = threadStacks.find(thread);
+        if (it == threadStacks.end()) continue;
+        ThreadStack& stack = it->second;
+        stack.running = false;
+        if (!stack.frames.empty()) {
+            stack.paused = true;
+            stack.pausedAt = now;
+            stack.allocPausedAt = allocated;
+        }
+    }
+    runningThreads.clear();
+
+    // Frames still open on the main thread were unwound by an error, which fires no return hooks
+    if (callbacks.empty()) {
+        auto main = threadStacks.find(mainThread);
+        if (main != threadStacks.end()) main->second.frames.clear();
+    }
+}
+
+void ScriptProfiler::onHook(void* userData, lua_State* L, lua_Debug* debug) {
+    static_cast<ScriptProfiler*>(userData)->handleHook(L, debug);
+}
+
+void ScriptProfiler::handleHook(lua_State* L, lua_Debug* debug) {
+    if (!enabled) return;
+    Clock::time_point now = Clock::now();
+    std::uint64_t allocated = sandbox.getBytesAllocated();
+
+    ThreadStack& stack = threadStacks[L];
+    if (stack.paused) {
+        for (Frame& frame : stack.frames) {
+            frame.start += now - stack.pausedAt;
+            frame.allocStart += allocated - stack.allocPausedAt;
+        }
+        stack.paused = false;
+    }
+    if (L != mainThread && !stack.running) {
+        stack.running = true;
+        runningThreads.push_back(L);
+    }
+
+    if (debug->event == LUA_HOOKRET) {
+        if (!stack.frames.empty()) closeFrame(stack, now, allocated);
+        return;
+    }
+    if (debug->event == LUA_HOOKTAILCALL && !stack.frames.empty()) {
+        closeFrame(stack, now, allocated);   // The caller's frame is reused and will not return
+    }
+    int function = findFunction(L, debug);
+    stack.frames.push_back({function, Clock::now(), sandbox.getBytesAllocated()});
+}
+
+int ScriptProfiler::findFunction(lua_State* L, lua_Debug* debug) {
+    lua_getinfo(L, "S", debug);
+    if (debug->what && std::strcmp(debug->what, "C") == 0) return -1;
+
+    FunctionKey key{debug->source, debug->linedefined};
+    auto it = functionIndex.find(key);
+    // Chunk names live as long as their functions, so a collected chunk's address can be reused
+    if (it != functionIndex.end() && functions[it->second].source == debug->source) {
+        return it->second;
+    }
+
+    lua_getinfo(L, "n", debug);
+    FunctionStats stats;
+    stats.source = debug->source ? debug->source : "?";
+    stats.line = debug->linedefined;
+    if (debug->what && std::strcmp(debug->what, "main") == 0) {
+        stats.name = "(main chunk)";
+    } else {
+        stats.name = debug->name ? debug->name : "(anonymous)";
+    }
+    int index = static_cast<int>(functions.size());
+    functions.push_back(std::move(stats));
+    functionIndex[key] = index;
+    return index;
+}
+
+void ScriptProfiler::closeFrame(ThreadStack& stack, Clock::time_point now, std::uint64_t allocated) {
+    Frame frame = stack.frames.back();
+    stack.frames.pop_back();
+    if (frame.function < 0) return;
+
+    double totalMs = elapsedMs(frame.start, now);
+    std::uint64_t totalAlloc = allocated - frame.allocStart;
+    FunctionStats& stats = functions[frame.function];
+    stats.calls++;
+    stats.totalMs += totalMs;
+    stats.selfMs += totalMs - frame.childMs;
+    stats.allocatedBytes += totalAlloc - frame.childAlloc;
+
+    // C frames are not timed: a Lua function called through one (pcall, a sort comparator) is a
+    // child of the nearest Lua caller, and time spent in C stays in that caller's self time
+    for (auto parent = stack.frames.rbegin(); parent != stack.frames.rend(); ++parent) {
+        if (parent->function < 0) continue;
+        parent->childMs += totalMs;
+        parent->childAlloc += totalAlloc;
+        break;
+    }
+}
+
+std::vector<ScriptProfiler::FunctionStats> ScriptProfiler::getFunctionStats() const {
+    std::vector<FunctionStats> result;
+    for (const FunctionStats& stats : functions) {
+        if (stats.calls > 0) result.push_back(stats);
+    }
+    std::sort(result.begin(), result.end(), [](const FunctionStats& a, const FunctionStats& b) { return a.selfMs > b.selfMs; });
+    return result;
+}
+
+std::vector<ScriptProfiler::EntityStats> ScriptProfiler::getEntityStats() const {
+    std::vector<EntityStats> result;
+    for (const EntityStats& stats : entities) {
+        if (stats.calls > 0) result.push_back(stats);
+    }
+    std::sort(result.begin(), result.end(), [](const EntityStats& a, const EntityStats& b) { return a.totalMs > b.totalMs; });
+    return result;
+}
+
+std::vector<ScriptProfiler::ScriptStats> ScriptProfiler::getScriptStats() const {
+    std::vector<ScriptStats> result;
+    std::unordered_map<std::string, int> entityCounts;
+    for (const EntityStats& stats : entities) {
+        if (stats.calls > 0) entityCounts[stats.scriptPath]++;
+    }
+    for (size_t i = 0; i < scripts.size(); ++i) {
+        if (scripts[i].calls == 0) continue;
+        ScriptStats stats = scripts[i];
+        stats.scriptPath = names[i];
+        auto count = entityCounts.find(stats.scriptPath);
+        stats.entities = count != entityCounts.end() ? count->second : 0;
+        result.push_back(std::move(stats));
+    }
+    std::sort(result.begin(), result.end(), [](const ScriptStats& a, const ScriptStats& b) { return a.totalMs > b.totalMs; });
+    return result;
+}
+
+bool ScriptProfiler::exportTrace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+    nlohmann::json events = nlohmann::json::array();
+    events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 0}, {"tid", 0}, {"args", {{"name", "Lua main state"}}}});
+    for (const TraceEvent& event : traceEvents) {
+        nlohmann::json entry = {
+            {"name", names[event.name]},
+            {"cat", "script"},
+            {"ph", "X"},
+            {"ts", event.startUs},
+            {"dur", event.durationUs},
+            {"pid", 0},
+            {"tid", 0}
+        };
+        if (!names[event.scriptPath].empty()) {
+            entry["args"]["script"] = names[event.scriptPath];
+        }
+        if (event.entity != NO_ENTITY) {
+            entry["args"]["entity"] = event.entity;
+        }
+        events.push_back(std::move(entry));
+    }
+
+    nlohmann::json functionTable = nlohmann::json::array();
+    for (const FunctionStats& stats : getFunctionStats()) {
+        functionTable.push_back({
+            {"name", stats.name},
+            {"source", stats.source},
+            {"line", stats.line},
+            {"calls", stats.calls},
+            {"totalMs", stats.totalMs},
+            {"selfMs", stats.selfMs},
+            {"allocatedBytes", stats.allocatedBytes}
+        });
+    }
+
+    nlohmann::json trace;
+    trace["traceEvents"] = std::move(events);
+    trace["displayTimeUnit"] = "ms";
+    trace["scriptFunctions"] = std::move(functionTable);
+    trace["frames"] = frames;
+    trace["droppedEvents"] = droppedEvents;
+    file << trace.dump();
+    return file.good();
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+#include "../Entity.h"
+#include "ScriptSandbox.h"
+
+// Attributes Lua cost to script files, entities and functions. While enabled, every script
+// callback made by the ScriptSystem is timed and recorded for the trace export, and a call/return
+// hook on the main state times each Lua function. When disabled no hook is installed and callback
+// scopes only test a flag.
+class ScriptProfiler {
+public:
+    explicit ScriptProfiler(const ScriptSandbox& sandbox) : sandbox(sandbox) {}
+
+    ScriptProfiler(const ScriptProfiler&) = delete;
+    ScriptProfiler& operator=(const ScriptProfiler&) = delete;
+
+    // Installing the hook is up to the owner of the state (ScriptSandbox::setCallHook with onHook)
+    void setEnabled(bool enable);
+    bool isEnabled() const { return enabled; }
+    void reset();
+
+    static void onHook(void* userData, lua_State* L, lua_Debug* debug);
+    void setMainThread(lua_State* L) { mainThread = L; }
+    void forgetThread(lua_State* thread) { threadStacks.erase(thread); }
+
+    // One per ScriptSystem::update; frames delimit the trace and give per-frame averages
+    void beginFrame();
+    void endFrame();
+    int getFrameCount() const { return frames; }
+
+    // Times one script callback. In the trace a nested callback (a script loading another) sits
+    // inside its parent; in the totals each callback only counts its own time.
+    class Scope {
+    public:
+        Scope(ScriptProfiler& profiler, Entity entity, const std::string& scriptPath, const char* callback)
+            : profiler(profiler.enabled ? &profiler : nullptr) {
+            if (this->profiler) this->profiler->beginCallback(entity, scriptPath, callback);
+        }
+        ~Scope() {
+            if (profiler) profiler->endCallback();
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ScriptProfiler* profiler;
+    };
+
+    struct FunctionStats {
+        std::string name;
+        std::string source;           // Lua chunk name, e.g. "@../assets/Scripts/player.lua"
+        int line = 0;
+        std::uint64_t calls = 0;
+        double totalMs = 0.0;         // Including callees
+        double selfMs = 0.0;
+        std::uint64_t allocatedBytes = 0;  // Allocated by the function itself
+    };
+
+    struct EntityStats {
+        Entity entity = NO_ENTITY;
+        std::string scriptPath;
+        std::uint64_t calls = 0;
+        double totalMs = 0.0;
+        std::uint64_t allocatedBytes = 0;
+    };
+
+    struct ScriptStats {
+        std::string scriptPath;
+        int entities = 0;
+        std::uint64_t calls = 0;
+        double totalMs = 0.0;
+        std::uint64_t allocatedBytes = 0;
+    };
+
+    // Sorted by cost: functions by self time, entities and scripts by total time
+    std::vector<FunctionStats> getFunctionStats() const;
+    std::vector<EntityStats> getEntityStats() const;
+    std::vector<ScriptStats> getScriptStats() const;
+
+    // Chrome trace event format (chrome://tracing, Perfetto): one event per frame and per callback,
+    // with the function table attached. Returns false if the file cannot be written.
+    bool exportTrace(const std::string& path) const;
+    size_t getDroppedEvents() const { return droppedEvents; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t MAX_TRACE_EVENTS = 250000;
+
+    struct Frame {
+        int function;                 // -1 for C functions: their time stays in the caller's self time
+        Clock::time_point start;
+        std::uint64_t allocStart;
+        double childMs = 0.0;
+        std::uint64_t childAlloc = 0;
+    };
+
+    // Coroutines keep their frames while suspended; the time they spend suspended is skipped
+    struct ThreadStack {
+        std::vector<Frame> frames;
+        bool running = false;         // Listed in runningThreads
+        bool paused = false;
+        Clock::time_point pausedAt;
+        std::uint64_t allocPausedAt = 0;
+    };
+
+    struct FunctionKey {
+        const char* source;
+        int line;
+        bool operator==(const FunctionKey& other) const { return source == other.source && line == other.line; }
+    };
+    struct FunctionKeyHash {
+        size_t operator()(const FunctionKey& key) const {
+            return std::hash<const void*>()(key.source) ^ (static_cast<size_t>(key.line) * 0x9E3779B9u);
+        }
+    };
+
+    struct Callback {
+        std::uint32_t name;           // Index into names
+        std::uint32_t scriptPath;
+        Entity entity;
+        Clock::time_point start;
+        std::uint64_t allocStart;
+        double childMs = 0.0;         // Entity and script totals count each callback's own time only
+        std::uint64_t childAlloc = 0;
+    };
+
+    struct TraceEvent {
+        std::uint32_t name;
+        std::uint32_t scriptPath;
+        Entity entity;
+        std::int64_t startUs;
+        std::int64_t durationUs;
+    };
+
+    void beginCallback(Entity entity, const std::string& scriptPath, const char* callback);
+    void endCallback();
+    void handleHook(lua_State* L, lua_Debug* debug);
+    int findFunction(lua_State* L, lua_Debug* debug);
+    void closeFrame(ThreadStack& stack, Clock::time_point now, std::uint64_t allocated);
+    std::uint32_t intern(const std::string& name);
+    std::int64_t toMicroseconds(Clock::time_point time) const;
+
+    const ScriptSandbox& sandbox;
+    bool enabled = false;
+    lua_State* mainThread = nullptr;
+
+    std::vector<FunctionStats> functions;
+    std::unordered_map<FunctionKey, int, FunctionKeyHash> functionIndex;
+    std::unordered_map<lua_State*, ThreadStack> threadStacks;
+    std::vector<lua_State*> runningThreads;   // Coroutine threads hooked since the last callback ended
+
+    std::vector<EntityStats> entities = std::vector<EntityStats>(MAX_ENTITIES);
+    std::vector<ScriptStats> scripts;    // Indexed by interned script path
+    std::vector<Callback> callbacks;  // Open callback scopes
+    std::vector<std::string> names;   // Interned script paths and callback names
+    std::unordered_map<std::string, std::uint32_t> nameIndex;
+
+    std::vector<TraceEvent> traceEvents;
+    size_t droppedEvents = 0;
+    Clock::time_point epoch = Clock::now();
+    Clock::time_point frameStart;
+    int frames = 0;
+};
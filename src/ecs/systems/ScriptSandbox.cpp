@@ -0,0 +1,129 @@
+#include "ScriptSandbox.h"
+#include <cstdlib>
+
+void ScriptSandbox::attach(lua_State* L) {
+    state = L;
+    // Blocks allocated before the switch are freed through the new allocator, so start from Lua's count
+    memoryUsed = static_cast<size_t>(lua_gc(L, LUA_GCCOUNT)) * 1024 + static_cast<size_t>(lua_gc(L, LUA_GCCOUNTB));
+    lua_setallocf(L, &ScriptSandbox::allocate, this);
+    applyHook(state);
+}
+
+void ScriptSandbox::hardenLibraries(sol::state_view lua) {
+    lua["dofile"] = sol::lua_nil;
+    lua["loadfile"] = sol::lua_nil;
+    sol::optional<sol::table> package = lua["package"];
+    if (package) {
+        (*package)["loadlib"] = sol::lua_nil;
+        (*package)["cpath"] = "";
+        sol::optional<sol::table> searchers = (*package)["searchers"];
+        if (searchers) {
+            (*searchers)[4] = sol::lua_nil;   // C searchers
+            (*searchers)[3] = sol::lua_nil;
+        }
+    }
+    lua.safe_script(R"(
+        local load = load
+        if load then
+            _G.load = function(chunk, name, mode, env) return load(chunk, name, "t", env) end
+        end
+    )");
+}
+
+void ScriptSandbox::setLimits(const Limits& newLimits) {
+    limits = newLimits;
+    if (state) applyHook(state);
+}
+
+void ScriptSandbox::setCallHook(CallHook hook, void* userData) {
+    callHook = hook;
+    callHookData = userData;
+    if (state) applyHook(state);
+}
+
+int ScriptSandbox::hookMask() const {
+    int mask = 0;
+    if (limits.enabled && limits.instructionBudget > 0) mask |= LUA_MASKCOUNT;
+    if (callHook) mask |= LUA_MASKCALL | LUA_MASKRET;
+    return mask;
+}
+
+void ScriptSandbox::applyHook(lua_State* thread) {
+    // Threads that kept an older hook are harmless: the hook re-checks the limits itself
+    int mask = hookMask();
+    if (mask != 0) {
+        lua_sethook(thread, &ScriptSandbox::dispatchHook, mask, HOOK_INTERVAL);
+    } else {
+        lua_sethook(thread, nullptr, 0, 0);
+    }
+    if (thread == state) hookTightened = false;
+}
+
+void ScriptSandbox::enter() {
+    if (depth++ > 0) return;
+    violation = Violation::NONE;
+    instructionsLeft = static_cast<std::int64_t>(limits.instructionBudget);
+    if (hookTightened) applyHook(state);
+}
+
+void ScriptSandbox::leave() {
+    --depth;
+}
+
+const char* ScriptSandbox::describe(Violation violation) {
+    switch (violation) {
+        case Violation::INSTRUCTIONS: return "exceeded its instruction budget";
+        case Violation::MEMORY: return "exceeded the Lua memory limit";
+        default: return "no limit exceeded";
+    }
+}
+
+void* ScriptSandbox::allocate(void* userData, void* block, size_t oldSize, size_t newSize) {
+    ScriptSandbox* sandbox = static_cast<ScriptSandbox*>(userData);
+    size_t previous = block ? oldSize : 0;   // For new blocks oldSize holds the object type instead
+    if (newSize == 0) {
+        std::free(block);
+        sandbox->memoryUsed -= previous;
+        return nullptr;
+    }
+
+    const Limits& limits = sandbox->limits;
+    if (sandbox->depth > 0 && limits.enabled && limits.memoryLimitBytes > 0 && newSize > previous &&
+        sandbox->memoryUsed - previous + newSize > limits.memoryLimitBytes) {
+        sandbox->violation = Violation::MEMORY;
+        return nullptr;   // Lua runs a full collection and retries once before raising the error
+    }
+
+    void* resized = std::realloc(block, newSize);
+    if (resized) {
+        sandbox->memoryUsed = sandbox->memoryUsed - previous + newSize;
+        if (newSize > previous) sandbox->bytesAllocated += newSize - previous;
+    }
+    return resized;
+}
+
+void ScriptSandbox::dispatchHook(lua_State* L, lua_Debug* debug) {
+    void* userData = nullptr;
+    lua_getallocf(L, &userData);
+    ScriptSandbox* sandbox = static_cast<ScriptSandbox*>(userData);
+    if (debug->event == LUA_HOOKCOUNT) {
+        sandbox->countInstructions(L);
+    } else if (sandbox->callHook) {
+        sandbox->callHook(sandbox->callHookData, L, debug);
+    }
+}
+
+void ScriptSandbox::countInstructions(lua_State* L) {
+    if (depth == 0 || !limits.enabled || limits.instructionBudget == 0) return;
+
+    instructionsLeft -= hookTightened ? 1 : HOOK_INTERVAL;
+    if (instructionsLeft > 0) return;
+
+    violation = Violation::INSTRUCTIONS;
+    if (!hookTightened) {
+        // Check every instruction from here on, so a pcall in the script cannot catch the error and keep looping
+        lua_sethook(L, &ScriptSandbox::dispatchHook, hookMask() | LUA_MASKCOUNT, 1);
+        hookTightened = true;
+    }
+    luaL_error(L, "instruction budget of %llu exceeded", static_cast<unsigned long long>(limits.instructionBudget));
+}
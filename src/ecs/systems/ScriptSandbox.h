@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sol/sol.hpp>
+
+// Limits for one Lua state. Script callbacks run inside a Scope: each outermost scope gets a fresh
+// instruction budget, counted by a debug hook, and allocations that would take the state's heap
+// past the memory limit fail, which raises a memory error in the script. Outside a scope nothing
+// is limited, so engine-side work on the state (loading, pushing arguments) is never cut short.
+class ScriptSandbox {
+public:
+    enum class Violation : std::uint8_t {
+        NONE,
+        INSTRUCTIONS,
+        MEMORY
+    };
+
+    struct Limits {
+        bool enabled = true;
+        std::uint64_t instructionBudget = 20000000;        // Per callback, in VM instructions; 0: unlimited
+        size_t memoryLimitBytes = 512u * 1024u * 1024u;     // Whole state; 0: unlimited
+    };
+
+    ScriptSandbox() = default;
+    ScriptSandbox(const ScriptSandbox&) = delete;
+    ScriptSandbox& operator=(const ScriptSandbox&) = delete;
+
+    // Installs the allocator and the hook. The sandbox must outlive the state.
+    void attach(lua_State* L);
+
+    // Removes what scripts must not reach from the opened standard libraries: reading files
+    // directly, loading native libraries and loading precompiled chunks (malformed bytecode can
+    // crash the VM). require of Lua files keeps working where the package library is open.
+    static void hardenLibraries(sol::state_view lua);
+    void setLimits(const Limits& newLimits);
+    const Limits& getLimits() const { return limits; }
+
+    class Scope {
+    public:
+        explicit Scope(ScriptSandbox& sandbox) : sandbox(sandbox) { sandbox.enter(); }
+        ~Scope() { sandbox.leave(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ScriptSandbox& sandbox;
+    };
+
+    // The limit that stopped the latest callback, if any; kept until the next outermost scope
+    Violation getViolation() const { return violation; }
+    static const char* describe(Violation violation);
+
+    size_t getMemoryUsed() const { return memoryUsed; }
+    std::uint64_t getBytesAllocated() const { return bytesAllocated; }   // Cumulative growth, for profiling
+
+    // Lua allows one hook per thread, so other users (the script profiler) receive call and return
+    // events through the sandbox's hook. Threads copy the hook when created; existing coroutine
+    // threads are updated with applyHook(thread).
+    using CallHook = void (*)(void* userData, lua_State* L, lua_Debug* debug);
+    void setCallHook(CallHook hook, void* userData);
+    void applyHook(lua_State* thread);
+
+private:
+    static constexpr int HOOK_INTERVAL = 10000;    // Instructions between budget checks
+
+    static void* allocate(void* userData, void* block, size_t oldSize, size_t newSize);
+    static void dispatchHook(lua_State* L, lua_Debug* debug);
+    void countInstructions(lua_State* L);
+    void enter();
+    void leave();
+    int hookMask() const;
+
+    lua_State* state = nullptr;
+    Limits limits;
+    int depth = 0;
+    std::int64_t instructionsLeft = 0;
+    bool hookTightened = false;
+    size_t memoryUsed = 0;
+    std::uint64_t bytesAllocated = 0;
+    CallHook callHook = nullptr;
+    void* callHookData = nullptr;
+    Violation violation = Violation::NONE;
+};
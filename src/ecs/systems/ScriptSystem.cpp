@@ -12,12 +12,16 @@
 #include "../components/EventComponent.h"
 #include "../components/StateMachineComponent.h"
 #include "../components/UIComponent.h"
+#include "../components/TilemapComponent.h"
+#include "ParticleSystem.h"
 #include "../../InputManager.h"
 #include <iostream>
 #include <fstream>
+#include <chrono>
+#include <algorithm>
 
 ScriptSystem::ScriptSystem(EntityManager* em, ComponentManager* cm)
-    : entityManager(em), componentManager(cm) {}
+    : entityManager(em), componentManager(cm), instanceSlots(MAX_ENTITIES, -1), componentRefs(MAX_ENTITIES) {}
 
 ScriptSystem::~ScriptSystem() {}
 
@@ -27,34 +31,459 @@ void ScriptSystem::setLoggingFunctions(std::function<void(const std::string&)> l
 }
 
 bool ScriptSystem::init() {
-    lua.open_libraries(sol::lib::base, sol::lib::package, sol::lib::string, sol::lib::math, sol::lib::table, sol::lib::io);
+    sandbox.attach(lua.lua_state());
+    profiler.setMainThread(lua.lua_state());
+    lua.open_libraries(sol::lib::base, sol::lib::package, sol::lib::coroutine, sol::lib::string, sol::lib::math, sol::lib::table);
+
+    ScriptSandbox::hardenLibraries(lua);
     std::cout << "ScriptSystem: Lua initialized." << std::endl;
     registerCoreAPI();
     registerEntityAPI();
+    registerComponentRefs();
+    applyGCSettings();
     return true;
 }
 
 void ScriptSystem::update(float deltaTime) {
-    std::cout << "[ScriptSystem] C++ update method CALLED. DeltaTime: " << deltaTime << std::endl; // ADDED THIS LOG
-    // Log("[ScriptSystem] Update called. Processing entities..."); // Optional: General system update log
-    for (auto entity : entityManager->getActiveEntities()) {
-        // Log("[ScriptSystem] Checking entity: " + std::to_string(entity)); // Optional: Log each entity being checked
-        if (componentManager->hasComponent<ScriptComponent>(entity)) {
-            auto& scriptComp = componentManager->getComponent<ScriptComponent>(entity);
-            std::cout << "[ScriptSystem] Entity " << entity << " has ScriptComponent with path: '" << scriptComp.scriptPath << "'" << std::endl; // Log 1
-            if (!scriptComp.scriptPath.empty()) {
-                // Check if the entity has a registered script environment
-                if (entityScriptEnvironments.count(entity)) {
-                    std::cout << "[ScriptSystem] Entity " << entity << " has a script environment. Attempting to call 'update'." << std::endl; // Log 2
-                    callScriptFunction(entity, "update", entity, deltaTime);
+    auto startTime = std::chrono::high_resolution_clock::now();
+    if (profiler.isEnabled()) {
+        profiler.beginFrame();
+    }
+
+    if (hotReloadEnabled) {
+        pollScriptChanges();
+    }
+
+    // Worker states run alongside the main state, against a snapshot taken now
+    bool workersRunning = workerPool && workerPool->getEntityCount() > 0;
+    if (workersRunning) {
+        buildWorkerSnapshot();
+        workerPool->beginFrame(&workerSnapshot, deltaTime);
+    }
+
+    // Scripts may load or unload scripts while running; those changes are applied after the loop
+    updatingScripts = true;
+    deliverMessages();
+    int suspendedScripts = 0;
+    for (size_t i = 0; i < scriptInstances.size(); ++i) {
+        ScriptInstance& instance = scriptInstances[i];
+        if (instance.removed) continue;
+        if (instance.suspended) {
+            suspendedScripts++;
+            continue;
+        }
+        if (instance.batch) {
+            instance.batch->batchMembers.push_back(instance.entity);
+            continue;
+        }
+        if (!instance.update.valid()) continue;
+
+        ScriptSandbox::Scope scope(sandbox);
+        ScriptProfiler::Scope profile(profiler, instance.entity, instance.scriptPath, "update");
+        sol::protected_function_result result = instance.shared
+            ? instance.update(instance.state, instance.entity, deltaTime)
+            : instance.update(instance.entity, deltaTime);
+        if (!result.valid() && (!instance.errorReported || sandbox.getViolation() != ScriptSandbox::Violation::NONE)) {
+            instance.errorReported = true;
+            reportScriptError(instance.entity, instance.scriptPath, "update", result);
+        }
+    }
+    runBatchedModules(deltaTime);
+
+    scriptTime += deltaTime;
+    ++scriptFrame;
+    resumeDueCoroutines();
+    updatingScripts = false;
+    compactInstances();
+
+    metrics.workerWaitTime = 0.0f;
+    metrics.workerCommands = 0;
+    if (workersRunning) {
+        auto waitStart = std::chrono::high_resolution_clock::now();
+        workerPool->endFrame(workerCommands, mainInbox);
+        metrics.workerWaitTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - waitStart).count();
+    } else if (workerPool) {
+        workerPool->endFrame(workerCommands, mainInbox);   // Collects output from worker init calls
+    }
+    applyWorkerCommands();
+    applyPendingWorkerChanges();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    metrics.updateTime = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+    metrics.scriptInstances = static_cast<int>(scriptInstances.size());
+    metrics.suspendedScripts = suspendedScripts;
+    metrics.workerEntities = workerPool ? workerPool->getEntityCount() : 0;
+    if (profiler.isEnabled()) {
+        profiler.endFrame();
+    }
+
+    stepGarbageCollector();
+}
+
+std::uint32_t ScriptSystem::createCoroutine(Entity entity, const std::string& scriptPath, const sol::protected_function& function) {
+    std::uint32_t slot;
+    if (!freeCoroutineSlots.empty()) {
+        slot = freeCoroutineSlots.back();
+        freeCoroutineSlots.pop_back();
+    } else {
+        slot = static_cast<std::uint32_t>(coroutines.size());
+        coroutines.emplace_back();
+    }
+
+    ScriptCoroutine& coroutine = coroutines[slot];
+    coroutine.entity = entity;
+    coroutine.scriptPath = scriptPath;
+    coroutine.thread = sol::thread::create(lua.lua_state());
+    coroutine.routine = sol::coroutine(coroutine.thread.thread_state(), function);
+    coroutine.serial++;
+    coroutine.active = true;
+    metrics.activeCoroutines++;
+    return slot;
+}
+
+void ScriptSystem::releaseCoroutine(std::uint32_t slot) {
+    ScriptCoroutine& coroutine = coroutines[slot];
+    if (!coroutine.active) return;
+    if (coroutine.running) {
+        // Stopped from inside its own body: the thread and the slot must outlive the resume,
+        // so scheduleCoroutine releases them when it returns. Queued wakes are already stale.
+        coroutine.stopping = true;
+        coroutine.serial++;
+        return;
+    }
+    if (profiler.isEnabled()) {
+        profiler.forgetThread(coroutine.thread.thread_state());
+    }
+    coroutine.active = false;
+    coroutine.stopping = false;
+    coroutine.serial++;
+    coroutine.routine = sol::coroutine();
+    coroutine.thread = sol::thread();
+    freeCoroutineSlots.push_back(slot);
+    metrics.activeCoroutines--;
+}
+
+void ScriptSystem::stopCoroutines(Entity entity) {
+    for (std::uint32_t slot = 0; slot < coroutines.size(); ++slot) {
+        if (coroutines[slot].active && coroutines[slot].entity == entity) {
+            releaseCoroutine(slot);
+        }
+    }
+}
+
+void ScriptSystem::scheduleCoroutine(std::uint32_t slot, sol::protected_function_result& result) {
+    ScriptCoroutine& coroutine = coroutines[slot];
+    coroutine.running = false;
+    if (coroutine.stopping) {
+        releaseCoroutine(slot); // Stopped from inside its own body
+        return;
+    }
+
+    if (!result.valid()) {
+        reportScriptError(coroutine.entity, coroutine.scriptPath, "coroutine", result);
+        releaseCoroutine(slot);
+        return;
+    }
+    if (result.status() != sol::call_status::yielded) {
+        releaseCoroutine(slot); // Returned normally
+        return;
+    }
+
+    // wait/waitFrames/waitForEvent yield (kind, argument); a bare coroutine.yield() waits one frame
+    CoroutineWait wait = CoroutineWait::FRAMES;
+    if (result.return_count() >= 1) {
+        wait = static_cast<CoroutineWait>(result.get<int>(0));
+    }
+
+    std::uint32_t serial = ++coroutine.serial;
+    switch (wait) {
+        case CoroutineWait::TIME: {
+            double seconds = result.return_count() >= 2 ? result.get<double>(1) : 0.0;
+            timeWakes.push({scriptTime + seconds, slot, serial});
+            break;
+        }
+        case CoroutineWait::EVENT: {
+            std::string eventName = result.return_count() >= 2 ? result.get<std::string>(1) : std::string();
+            eventWakes[EventNames::intern(eventName)].push_back({0.0, slot, serial});
+            eventWaiters++;
+            break;
+        }
+        case CoroutineWait::FRAMES:
+        default: {
+            int frames = result.return_count() >= 2 ? result.get<int>(1) : 1;
+            frameWakes.push({static_cast<double>(scriptFrame + std::max(frames, 1)), slot, serial});
+            break;
+        }
+    }
+}
+
+void ScriptSystem::resumeDueCoroutines() {
+    metrics.coroutinesResumed = 0;
+    dueCoroutines.clear();
+
+    // Collect everything due first, so coroutines re-queued while resuming wait for the next frame
+    while (!timeWakes.empty() && timeWakes.top().due <= scriptTime) {
+        const CoroutineWake& wake = timeWakes.top();
+        if (coroutines[wake.slot].serial == wake.serial) dueCoroutines.push_back({wake.slot, false, NO_ENTITY});
+        timeWakes.pop();
+    }
+    while (!frameWakes.empty() && frameWakes.top().due <= static_cast<double>(scriptFrame)) {
+        const CoroutineWake& wake = frameWakes.top();
+        if (coroutines[wake.slot].serial == wake.serial) dueCoroutines.push_back({wake.slot, false, NO_ENTITY});
+        frameWakes.pop();
+    }
+    if (eventSystem && eventWaiters > 0) {
+        while (const EventData* event = eventSystem->readNext(eventCursor)) {
+            auto it = eventWakes.find(event->nameId);
+            if (it == eventWakes.end()) continue;
+            auto& waiters = it->second;
+            for (size_t i = 0; i < waiters.size();) {
+                const ScriptCoroutine& coroutine = coroutines[waiters[i].slot];
+                bool stale = coroutine.serial != waiters[i].serial;
+                bool addressed = event->target == NO_ENTITY || event->target == coroutine.entity;
+                if (stale || addressed) {
+                    if (!stale) dueCoroutines.push_back({waiters[i].slot, true, event->sender});
+                    waiters[i] = waiters.back();
+                    waiters.pop_back();
+                    eventWaiters--;
+                    continue;
+                }
+                ++i;
+            }
+            if (waiters.empty()) eventWakes.erase(it);
+        }
+    } else if (eventSystem) {
+        // Nobody is waiting: skip this frame's events rather than replaying them later
+        eventCursor.frame = eventSystem->getFrameNumber();
+        eventCursor.position = eventSystem->getFrameEvents().size();
+    }
+
+    for (const DueCoroutine& due : dueCoroutines) {
+        ScriptCoroutine& coroutine = coroutines[due.slot];
+        if (!coroutine.active) continue; // Stopped by a coroutine resumed earlier this frame
+        metrics.coroutinesResumed++;
+        ScriptSandbox::Scope scope(sandbox);
+        ScriptProfiler::Scope profile(profiler, coroutine.entity, coroutine.scriptPath, "coroutine");
+        coroutine.running = true;
+        sol::protected_function_result result = due.fromEvent ? coroutine.routine(due.sender) : coroutine.routine();
+        scheduleCoroutine(due.slot, result);
+    }
+}
+
+void ScriptSystem::setWorkerCount(int count) {
+    count = std::max(count, 0);
+    if (count == getWorkerCount() || (workerPool && workerPool->isRunning())) return;
+
+    // Parallel entities are reloaded onto the new pool, or onto the main state when it goes away
+    std::vector<std::pair<Entity, std::string>> parallelEntities;
+    if (workerPool) {
+        parallelEntities = workerPool->getEntities();
+        workerPool->endFrame(workerCommands, mainInbox);
+        applyWorkerCommands();
+        workerPool.reset();
+    }
+    if (count > 0) {
+        workerPool = std::make_unique<ScriptWorkerPool>(count);
+        workerPool->setSandboxLimits(sandbox.getLimits());
+        for (const auto& instance : scriptInstances) {
+            auto it = scriptModules.find(instance.scriptPath);
+            if (!instance.removed && it != scriptModules.end() && it->second.parallel) {
+                parallelEntities.emplace_back(instance.entity, instance.scriptPath);
+            }
+        }
+    }
+    for (const auto& [entity, scriptPath] : parallelEntities) {
+        loadScript(entity, scriptPath);
+    }
+}
+
+std::vector<ScriptWorkerPool::WorkerMetrics> ScriptSystem::getWorkerMetrics() const {
+    if (!workerPool || workerPool->isRunning()) return {};
+    return workerPool->getMetrics();
+}
+
+void ScriptSystem::buildWorkerSnapshot() {
+    std::fill(workerSnapshot.entries.begin(), workerSnapshot.entries.end(), ScriptSnapshot::Entry());
+    for (Entity entity : entityManager->getActiveEntities()) {
+        ScriptSnapshot::Entry& entry = workerSnapshot.entries[entity];
+        if (componentManager->hasComponent<TransformComponent>(entity)) {
+            auto& transform = componentManager->getComponent<TransformComponent>(entity);
+            entry.hasTransform = true;
+            entry.x = transform.x;
+            entry.y = transform.y;
+        }
+        if (componentManager->hasComponent<VelocityComponent>(entity)) {
+            auto& velocity = componentManager->getComponent<VelocityComponent>(entity);
+            entry.hasVelocity = true;
+            entry.vx = velocity.vx;
+            entry.vy = velocity.vy;
+        }
+    }
+}
+
+void ScriptSystem::applyWorkerCommands() {
+    metrics.workerCommands += static_cast<int>(workerCommands.size());
+    for (const ScriptCommand& command : workerCommands) {
+        switch (command.type) {
+            case ScriptCommand::Type::SET_POSITION:
+            case ScriptCommand::Type::MOVE:
+                if (componentManager->hasComponent<TransformComponent>(command.entity)) {
+                    auto& transform = componentManager->getComponent<TransformComponent>(command.entity);
+                    if (command.type == ScriptCommand::Type::MOVE) {
+                        transform.x += command.x;
+                        transform.y += command.y;
+                    } else {
+                        transform.x = command.x;
+                        transform.y = command.y;
+                    }
+                }
+                break;
+            case ScriptCommand::Type::SET_VELOCITY:
+                if (componentManager->hasComponent<VelocityComponent>(command.entity)) {
+                    auto& velocity = componentManager->getComponent<VelocityComponent>(command.entity);
+                    velocity.vx = command.x;
+                    velocity.vy = command.y;
+                }
+                break;
+            case ScriptCommand::Type::SEND_EVENT:
+                if (componentManager->hasComponent<EventComponent>(command.entity)) {
+                    componentManager->getComponent<EventComponent>(command.entity).sendCustomEvent(command.text);
+                }
+                break;
+            case ScriptCommand::Type::LOG:
+                if (logCallback) {
+                    logCallback("[LUA] " + command.text);
                 } else {
-                    std::cerr << "[ScriptSystem] ERROR: Entity " << entity << " has ScriptComponent but NO script environment registered. Cannot call 'update'." << std::endl; // Log 3
+                    std::cout << "[LUA] " << command.text << std::endl;
                 }
-            } else {
-                 std::cout << "[ScriptSystem] Entity " << entity << " has ScriptComponent but scriptPath is EMPTY." << std::endl; // Log 4
+                break;
+            case ScriptCommand::Type::LOG_ERROR:
+                if (errorLogCallback) {
+                    errorLogCallback("[LUA ERROR] " + command.text);
+                } else {
+                    std::cerr << "[LUA ERROR] " << command.text << std::endl;
+                }
+                break;
+        }
+    }
+    workerCommands.clear();
+}
+
+void ScriptSystem::applyPendingWorkerChanges() {
+    if (!workerPool) return;
+    for (Entity entity : pendingWorkerUnloads) {
+        workerPool->removeEntity(entity);
+    }
+    pendingWorkerUnloads.clear();
+    for (const auto& [entity, scriptPath] : pendingWorkerLoads) {
+        ScriptModule* module = acquireModule(scriptPath);
+        if (module) workerPool->addEntity(entity, scriptPath, module->bytecode);
+    }
+    pendingWorkerLoads.clear();
+    for (ScriptMessage& message : pendingWorkerMessages) {
+        workerPool->postMessage(std::move(message));
+    }
+    pendingWorkerMessages.clear();
+}
+
+void ScriptSystem::postMessage(ScriptMessage&& message) {
+    if (workerPool && (workerPool->owns(message.target) || std::any_of(pendingWorkerLoads.begin(), pendingWorkerLoads.end(),
+            [&](const auto& load) { return load.first == message.target; }))) {
+        if (workerPool->isRunning()) {
+            pendingWorkerMessages.push_back(std::move(message));
+        } else {
+            workerPool->postMessage(std::move(message));
+        }
+        return;
+    }
+    mainInbox.push_back(std::move(message));
+}
+
+void ScriptSystem::deliverMessages() {
+    metrics.messagesDelivered = 0;
+    if (mainInbox.empty()) return;
+
+    // Messages posted while delivering wait for the next frame
+    deliveringMessages.swap(mainInbox);
+    for (const ScriptMessage& message : deliveringMessages) {
+        ScriptInstance* target = findInstance(message.target);
+        if (!target || target->removed || target->suspended) continue;
+
+        // on_message may unload or load scripts, which invalidates target
+        std::string scriptPath = target->scriptPath;
+        sol::protected_function_result result = callScriptFunction(message.target, "on_message", message.target, message.name, message.getValue(lua), message.sender);
+        if (!result.valid()) {
+            reportScriptError(message.target, scriptPath, "on_message", result);
+        }
+        metrics.messagesDelivered++;
+    }
+    deliveringMessages.clear();
+}
+
+void ScriptSystem::setGCSettings(const GCSettings& settings) {
+    gcSettings = settings;
+    applyGCSettings();
+}
+
+void ScriptSystem::applyGCSettings() {
+    lua_State* L = lua.lua_state();
+    if (gcSettings.generational) {
+        lua_gc(L, LUA_GCGEN, gcSettings.generationalMinorMultiplier, gcSettings.generationalMajorMultiplier);
+    } else {
+        lua_gc(L, LUA_GCINC, gcSettings.incrementalPause, gcSettings.incrementalStepMultiplier, 0);
+    }
+    lua_gc(L, gcSettings.budgeted ? LUA_GCSTOP : LUA_GCRESTART);
+}
+
+size_t ScriptSystem::luaHeapBytes() {
+    lua_State* L = lua.lua_state();
+    return static_cast<size_t>(lua_gc(L, LUA_GCCOUNT)) * 1024 + static_cast<size_t>(lua_gc(L, LUA_GCCOUNTB));
+}
+
+void ScriptSystem::stepGarbageCollector() {
+    lua_State* L = lua.lua_state();
+    size_t heapBefore = luaHeapBytes();
+    metrics.gcSteps = 0;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    if (gcSettings.budgeted) {
+        if (heapBefore > static_cast<size_t>(gcSettings.emergencyHeapMB) * 1024 * 1024) {
+            // The budget is not keeping up with allocation; pay for one full collection now
+            lua_gc(L, LUA_GCCOLLECT);
+            metrics.gcEmergencyCollections++;
+            metrics.gcCyclesCompleted++;
+        } else {
+            // Steps still run while the automatic collector is stopped
+            float elapsedMs = 0.0f;
+            while (elapsedMs < gcSettings.stepBudgetMs) {
+                metrics.gcSteps++;
+                if (lua_gc(L, LUA_GCSTEP, gcSettings.stepSizeKB)) {
+                    metrics.gcCyclesCompleted++;
+                    break; // A cycle finished; nothing left worth collecting this frame
+                }
+                // In generational mode a step is a whole minor collection and never reports a
+                // finished cycle, so further steps would only repeat it for the rest of the budget
+                if (gcSettings.generational) {
+                    metrics.gcCyclesCompleted++;
+                    break;
+                }
+                elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
             }
         }
     }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    metrics.gcStepTime = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+
+    size_t heapAfter = luaHeapBytes();
+    metrics.heapBytes = heapAfter;
+    metrics.peakHeapBytes = std::max(metrics.peakHeapBytes, heapBefore);
+    metrics.collectedBytes = heapBefore > heapAfter ? heapBefore - heapAfter : 0;
+}
+
+void ScriptSystem::resetMetrics() {
+    int activeCoroutines = metrics.activeCoroutines;
+    metrics = PerformanceMetrics{};
+    metrics.activeCoroutines = activeCoroutines;   // A live count, not a statistic
 }
 
 bool ScriptSystem::loadScript(Entity entity, const std::string& scriptPath) {
@@ -70,33 +499,650 @@ bool ScriptSystem::loadScript(Entity entity, const std::string& scriptPath) {
     }
     scriptFile.close();
 
-    sol::environment env(lua, sol::create, lua.globals());
-    entityScriptEnvironments[entity] = env;
+    // Reloading replaces the previous instance
+    unloadScript(entity);
+
+    ScriptModule* module = acquireModule(scriptPath);
+    if (!module) {
+        return false;
+    }
+    if (workerPool && module->shared && module->parallel) {
+        return loadOnWorker(entity, scriptPath, *module);
+    }
+
+    ScriptInstance instance;
+    instance.entity = entity;
+    instance.scriptPath = scriptPath;
 
     try {
-        auto result = lua.safe_script_file(scriptPath, entityScriptEnvironments[entity]);
-        if (!result.valid()) {
-            sol::error err = result;
-            std::cerr << "ScriptSystem Error: Failed to load or execute script '" << scriptPath << "' for entity " << entity << ": " << err.what() << std::endl;
-            entityScriptEnvironments.erase(entity);
+        if (!instantiateScript(*module, instance)) {
             return false;
         }
+        if (workerPool && instance.shared && module->parallel) {
+            // First load of the module is what revealed it as parallel
+            return loadOnWorker(entity, scriptPath, *module);
+        }
         std::cout << "ScriptSystem: Successfully loaded script '" << scriptPath << "' for entity " << entity << std::endl;
 
-        sol::protected_function_result initResult = callScriptFunction(entity, "init", entity);
-        if (!initResult.valid()) {
-            sol::error err = initResult;
+        sol::protected_function init = instance.init;
+        sol::table state = instance.state;
+        bool shared = instance.shared;
+        sol::protected_function run;
+        if (shared) {
+            run = state["run"];
+        } else {
+            run = instance.env["run"];
+        }
+        addInstance(std::move(instance));
+
+        if (init.valid()) {
+            ScriptSandbox::Scope scope(sandbox);
+            ScriptProfiler::Scope profile(profiler, entity, scriptPath, "init");
+            sol::protected_function_result initResult = shared ? init(state, entity) : init(entity);
+            if (!initResult.valid()) {
+                reportScriptError(entity, scriptPath, "init", initResult);
+                return true;
+            }
+        }
+
+        // run(entity) is started as the entity's main coroutine
+        if (run.valid()) {
+            if (shared) {
+                startCoroutine(entity, scriptPath, run, state, entity);
+            } else {
+                startCoroutine(entity, scriptPath, run, entity);
+            }
         }
 
     } catch (const sol::error& e) {
         std::cerr << "ScriptSystem Sol2 Error: Exception during script load for entity " << entity << " with script '" << scriptPath << "': " << e.what() << std::endl;
-        entityScriptEnvironments.erase(entity);
+        unloadScript(entity);
         return false;
     }
 
     return true;
 }
 
+bool ScriptSystem::loadOnWorker(Entity entity, const std::string& scriptPath, ScriptModule& module) {
+    if (workerPool->isRunning()) {
+        pendingWorkerLoads.emplace_back(entity, scriptPath);
+        return true;
+    }
+    if (!workerPool->addEntity(entity, scriptPath, module.bytecode)) {
+        std::cerr << "ScriptSystem Error: Failed to load parallel script '" << scriptPath << "' for entity " << entity << " on a worker" << std::endl;
+        return false;
+    }
+    std::cout << "ScriptSystem: Loaded parallel script '" << scriptPath << "' for entity " << entity << " on a worker" << std::endl;
+    return true;
+}
+
+ScriptSystem::ScriptModule* ScriptSystem::acquireModule(const std::string& scriptPath) {
+    std::error_code ec;
+    auto writeTime = std::filesystem::last_write_time(scriptPath, ec);
+
+    auto it = scriptModules.find(scriptPath);
+    if (it != scriptModules.end()) {
+        if (ec || it->second.writeTime == writeTime) return &it->second;
+
+        // Changed on disk since it was compiled. Loaded instances share this module, so the new
+        // version is swapped in place as on hot reload; if that fails the previous one stays.
+        ScriptModule& module = it->second;
+        if (module.parallel && workerPool && workerPool->isRunning()) {
+            return &module;   // Worker states cannot reload mid-frame; a later load or hot reload applies it
+        }
+        applyCompiledScript(scriptPath, compileScriptFile(scriptPath));
+        module.writeTime = writeTime;   // Not retried on every load; the watcher reports the next save
+        return &module;
+    }
+
+    // First use
+    sol::load_result loaded = lua.load_file(scriptPath);
+    if (!loaded.valid()) {
+        sol::error err = loaded;
+        std::cerr << "ScriptSystem Error: Failed to compile script '" << scriptPath << "': " << err.what() << std::endl;
+        return nullptr;
+    }
+    sol::protected_function chunk = loaded;
+
+    ScriptModule module;
+    module.scriptPath = scriptPath;
+    module.writeTime = writeTime;
+    sol::bytecode bytecode = chunk.dump();
+    module.bytecode.assign(bytecode.as_string_view());
+
+    auto& cached = scriptModules[scriptPath];
+    cached = std::move(module);
+    scriptWatcher.watch(scriptPath);
+    return &cached;
+}
+
+ScriptSystem::ScriptCompileResult ScriptSystem::compileScriptFile(const std::string& scriptPath) {
+    // Runs on a background thread, so it uses a throwaway state rather than the system's
+    ScriptCompileResult compiled;
+    std::ifstream file(scriptPath, std::ios::binary);
+    if (!file.is_open()) {
+        compiled.error = "could not open file";
+        return compiled;
+    }
+    std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::error_code ec;
+    compiled.writeTime = std::filesystem::last_write_time(scriptPath, ec);
+
+    lua_State* L = luaL_newstate();
+    if (!L) {
+        compiled.error = "out of memory";
+        return compiled;
+    }
+    std::string chunkName = "@" + scriptPath;
+    if (luaL_loadbufferx(L, source.data(), source.size(), chunkName.c_str(), "t") != LUA_OK) {
+        const char* message = lua_tostring(L, -1);
+        compiled.error = message ? message : "unknown error";
+    } else {
+        lua_dump(L, [](lua_State*, const void* data, size_t size, void* userData) -> int {
+            static_cast<std::string*>(userData)->append(static_cast<const char*>(data), size);
+            return 0;
+        }, &compiled.bytecode, 0);
+        compiled.success = true;
+    }
+    lua_close(L);
+    return compiled;
+}
+
+void ScriptSystem::pollScriptChanges() {
+    changedScripts.clear();
+    scriptWatcher.poll(changedScripts);
+    for (const std::string& scriptPath : changedScripts) {
+        compileJobs.push_back({scriptPath, std::async(std::launch::async, &ScriptSystem::compileScriptFile, scriptPath)});
+    }
+
+    // Finished jobs are applied oldest first, so the latest save wins
+    for (auto it = compileJobs.begin(); it != compileJobs.end();) {
+        if (it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+        applyCompiledScript(it->scriptPath, it->result.get());
+        it = compileJobs.erase(it);
+    }
+}
+
+void ScriptSystem::applyCompiledScript(const std::string& scriptPath, const ScriptCompileResult& compiled) {
+    if (!compiled.success) {
+        metrics.reloadFailures++;
+        std::string message = "[LUA ERROR] Reload of '" + scriptPath + "' failed to compile, keeping the previous version: " + compiled.error;
+        if (errorLogCallback) errorLogCallback(message); else std::cerr << message << std::endl;
+        return;
+    }
+    auto moduleIt = scriptModules.find(scriptPath);
+    if (moduleIt != scriptModules.end() && moduleIt->second.writeTime == compiled.writeTime &&
+        moduleIt->second.bytecode == compiled.bytecode) {
+        return;   // Already swapped in, by a load that found the file changed
+    }
+    if (reloadModule(scriptPath, compiled)) {
+        metrics.scriptsReloaded++;
+        std::string message = "[ScriptSystem] Reloaded '" + scriptPath + "'";
+        if (logCallback) logCallback(message); else std::cout << message << std::endl;
+    } else {
+        metrics.reloadFailures++;
+    }
+}
+
+bool ScriptSystem::reloadModule(const std::string& scriptPath, const ScriptCompileResult& compiled) {
+    auto moduleIt = scriptModules.find(scriptPath);
+    if (moduleIt == scriptModules.end()) return false;
+    ScriptModule& module = moduleIt->second;
+
+    auto reportRollback = [this, &scriptPath](Entity entity, sol::protected_function_result& result) {
+        sol::error err = result;
+        std::string message = "[LUA ERROR] Reload of '" + scriptPath + "' failed" +
+            (entity != NO_ENTITY ? " for entity " + std::to_string(entity) : std::string()) +
+            ", keeping the previous version: " + err.what();
+        if (errorLogCallback) errorLogCallback(message); else std::cerr << message << std::endl;
+    };
+
+    if (module.shared) {
+        // Run the new version once; on success its contents replace the live module table
+        sol::environment env(lua, sol::create, lua.globals());
+        ScriptSandbox::Scope scope(sandbox);
+        sol::protected_function_result result = lua.safe_script(compiled.bytecode, env, "@" + scriptPath, sol::load_mode::binary);
+        if (!result.valid()) {
+            reportRollback(NO_ENTITY, result);
+            return false;
+        }
+        if (result.get_type() != sol::type::table) {
+            std::string message = "[LUA ERROR] Reload of '" + scriptPath + "' no longer returns a module table, keeping the previous version";
+            if (errorLogCallback) errorLogCallback(message); else std::cerr << message << std::endl;
+            return false;
+        }
+        sol::table fresh = result;
+        replaceTableContents(module.table, fresh);
+
+        sol::protected_function init = module.table["init"];
+        sol::protected_function update = module.table["update"];
+        sol::protected_function updateBatch = module.table["update_batch"];
+        setModuleBatch(module, updateBatch);   // update_batch may have been added or removed
+        // Pending instances were loaded during this update, which can trigger a reload
+        for (std::vector<ScriptInstance>* instances : {&scriptInstances, &pendingInstances}) {
+            for (ScriptInstance& instance : *instances) {
+                if (instance.removed || instance.scriptPath != scriptPath) continue;
+                instance.init = init;
+                instance.update = update;
+                instance.batch = module.batchListed ? &module : nullptr;
+                instance.errorReported = false;
+                instance.suspended = false;   // A fixed version gets another chance
+            }
+        }
+        module.batchErrorReported = false;
+    } else {
+        // Old-style scripts: each entity's environment gets the new functions; its other globals stay
+        bool anyFailed = false;
+        for (std::vector<ScriptInstance>* instances : {&scriptInstances, &pendingInstances}) {
+            for (ScriptInstance& instance : *instances) {
+                if (instance.removed || instance.scriptPath != scriptPath) continue;
+                sol::environment fresh(lua, sol::create, lua.globals());
+                ScriptSandbox::Scope scope(sandbox);
+                sol::protected_function_result result = lua.safe_script(compiled.bytecode, fresh, "@" + scriptPath, sol::load_mode::binary);
+                if (!result.valid()) {
+                    reportRollback(instance.entity, result);
+                    anyFailed = true;
+                    continue;
+                }
+                fresh.for_each([&instance](const sol::object& key, const sol::object& value) {
+                    if (value.get_type() == sol::type::function) {
+                        instance.env.raw_set(key, value);
+                    }
+                });
+                sol::protected_function init = instance.env["init"];
+                sol::protected_function update = instance.env["update"];
+                instance.init = init;
+                instance.update = update;
+                instance.errorReported = false;
+                instance.suspended = false;   // A fixed version gets another chance
+            }
+        }
+        if (anyFailed) return false;
+    }
+
+    module.bytecode = compiled.bytecode;
+    module.writeTime = compiled.writeTime;
+    if (workerPool) {
+        workerPool->reloadModule(scriptPath, compiled.bytecode);
+    }
+    return true;
+}
+
+bool ScriptSystem::instantiateScript(ScriptModule& module, ScriptInstance& instance) {
+    if (!module.shared) {
+        sol::environment env(lua, sol::create, lua.globals());
+        ScriptSandbox::Scope scope(sandbox);
+        ScriptProfiler::Scope profile(profiler, instance.entity, instance.scriptPath, "load");
+        sol::protected_function_result result = lua.safe_script(module.bytecode, env, "@" + instance.scriptPath, sol::load_mode::binary);
+        if (!result.valid()) {
+            sol::error err = result;
+            std::cerr << "ScriptSystem Error: Failed to load or execute script '" << instance.scriptPath << "' for entity " << instance.entity << ": " << err.what() << std::endl;
+            return false;
+        }
+
+        bool returnedModule = !module.probed && result.get_type() == sol::type::table;
+        module.probed = true;
+        if (!returnedModule) {
+            sol::protected_function init = env["init"];
+            sol::protected_function update = env["update"];
+            instance.env = env;
+            instance.init = init;
+            instance.update = update;
+            return true;
+        }
+
+        sol::table moduleTable = result;
+        module.table = moduleTable;
+        module.instanceMetatable = lua.create_table();
+        module.instanceMetatable["__index"] = moduleTable;
+        module.shared = true;
+        sol::object parallel = moduleTable["parallel"];
+        module.parallel = parallel.get_type() == sol::type::boolean && parallel.as<bool>();
+    }
+
+    sol::table state = lua.create_table();
+    state["entity"] = instance.entity;
+    state[sol::metatable_key] = module.instanceMetatable;
+
+    sol::protected_function init = module.table["init"];
+    sol::protected_function update = module.table["update"];
+    sol::protected_function updateBatch = module.table["update_batch"];
+    instance.shared = true;
+    instance.state = state;
+    instance.init = init;
+    instance.update = update;
+
+    setModuleBatch(module, updateBatch);
+    instance.batch = module.batchListed ? &module : nullptr;
+    return true;
+}
+
+void ScriptSystem::setModuleBatch(ScriptModule& module, const sol::protected_function& updateBatch) {
+    module.updateBatch = updateBatch;
+    if (updateBatch.valid()) {
+        if (!module.batchEntities.valid()) {
+            module.batchEntities = lua.create_table(64, 0);
+            module.batchTableSize = 0;
+        }
+        if (!module.batchListed) {
+            batchedModules.push_back(&module);
+            module.batchListed = true;
+        }
+    } else if (module.batchListed) {
+        batchedModules.erase(std::remove(batchedModules.begin(), batchedModules.end(), &module), batchedModules.end());
+        module.batchListed = false;
+        module.batchMembers.clear();
+    }
+}
+
+void ScriptSystem::runBatchedModules(float deltaTime) {
+    // By index: an update_batch call may load or reload scripts, which changes the list
+    for (size_t m = 0; m < batchedModules.size(); ++m) {
+        ScriptModule* module = batchedModules[m];
+        std::vector<Entity>& members = module->batchMembers;
+        // Members unloaded or suspended after they were listed this frame are left out
+        members.erase(std::remove_if(members.begin(), members.end(), [this](Entity member) {
+            ScriptInstance* instance = findInstance(member);
+            return !instance || instance->removed || instance->suspended;
+        }), members.end());
+        if (members.empty() || !module->updateBatch.valid()) {
+            members.clear();
+            continue;
+        }
+
+        // Refill the module's entity array in place; trailing slots from a larger frame are cleared
+        sol::table& entities = module->batchEntities;
+        for (size_t i = 0; i < members.size(); ++i) {
+            entities.raw_set(i + 1, members[i]);
+        }
+        for (size_t i = members.size(); i < module->batchTableSize; ++i) {
+            entities.raw_set(i + 1, sol::lua_nil);
+        }
+        module->batchTableSize = members.size();
+
+        ScriptSandbox::Scope scope(sandbox);
+        ScriptProfiler::Scope profile(profiler, NO_ENTITY, module->scriptPath, "update_batch");
+        sol::protected_function_result result = module->updateBatch(entities, deltaTime);
+        if (!result.valid() && (!module->batchErrorReported || sandbox.getViolation() != ScriptSandbox::Violation::NONE)) {
+            module->batchErrorReported = true;
+            reportScriptError(members.front(), module->scriptPath, "update_batch", result);
+            if (sandbox.getViolation() != ScriptSandbox::Violation::NONE) {
+                for (Entity member : members) suspendScript(member);   // They share the call that hit the limit
+            }
+        }
+        members.clear();
+    }
+}
+
+void ScriptSystem::unloadScript(Entity entity) {
+    if (entity >= MAX_ENTITIES) return;
+    if (workerPool) {
+        pendingWorkerLoads.erase(std::remove_if(pendingWorkerLoads.begin(), pendingWorkerLoads.end(),
+            [entity](const auto& load) { return load.first == entity; }), pendingWorkerLoads.end());
+        if (workerPool->owns(entity)) {
+            if (workerPool->isRunning()) {
+                pendingWorkerUnloads.push_back(entity);
+            } else {
+                workerPool->removeEntity(entity);
+            }
+            return;
+        }
+    }
+    if (metrics.activeCoroutines > 0) {
+        stopCoroutines(entity);
+    }
+    int slot = instanceSlots[entity];
+    if (slot < 0) {
+        // Possibly loaded during this update and not merged yet
+        for (auto it = pendingInstances.begin(); it != pendingInstances.end(); ++it) {
+            if (it->entity == entity) {
+                pendingInstances.erase(it);
+                return;
+            }
+        }
+        return;
+    }
+
+    instanceSlots[entity] = -1;
+    if (updatingScripts) {
+        scriptInstances[slot].removed = true;
+        return;
+    }
+
+    // Swap-remove keeps the array dense
+    size_t last = scriptInstances.size() - 1;
+    if (static_cast<size_t>(slot) != last) {
+        scriptInstances[slot] = std::move(scriptInstances[last]);
+        instanceSlots[scriptInstances[slot].entity] = slot;
+    }
+    scriptInstances.pop_back();
+}
+
+bool ScriptSystem::hasScript(Entity entity) const {
+    if (entity >= MAX_ENTITIES) return false;
+    if (instanceSlots[entity] >= 0) return true;
+    if (workerPool && workerPool->owns(entity)) return true;
+    for (const auto& load : pendingWorkerLoads) {
+        if (load.first == entity) return true;
+    }
+    for (const auto& instance : pendingInstances) {
+        if (instance.entity == entity) return true;
+    }
+    return false;
+}
+
+void ScriptSystem::removeEntity(Entity entity) {
+    System::removeEntity(entity);
+    unloadScript(entity);
+}
+
+ScriptSystem::ScriptInstance* ScriptSystem::findInstance(Entity entity) {
+    if (entity >= MAX_ENTITIES) return nullptr;
+    int slot = instanceSlots[entity];
+    if (slot >= 0) return &scriptInstances[slot];
+    for (auto& instance : pendingInstances) {
+        if (instance.entity == entity) return &instance;
+    }
+    return nullptr;
+}
+
+void ScriptSystem::addInstance(ScriptInstance&& instance) {
+    if (updatingScripts) {
+        // Appending could reallocate the array update() is iterating
+        pendingInstances.push_back(std::move(instance));
+        return;
+    }
+    instanceSlots[instance.entity] = static_cast<int>(scriptInstances.size());
+    scriptInstances.push_back(std::move(instance));
+}
+
+void ScriptSystem::compactInstances() {
+    for (size_t i = 0; i < scriptInstances.size();) {
+        if (scriptInstances[i].removed) {
+            if (i != scriptInstances.size() - 1) {
+                scriptInstances[i] = std::move(scriptInstances.back());
+                if (!scriptInstances[i].removed) {
+                    instanceSlots[scriptInstances[i].entity] = static_cast<int>(i);
+                }
+            }
+            scriptInstances.pop_back();
+            continue;
+        }
+        ++i;
+    }
+
+    for (auto& instance : pendingInstances) {
+        addInstance(std::move(instance));
+    }
+    pendingInstances.clear();
+}
+
+void ScriptSystem::reportScriptError(Entity entity, const std::string& scriptPath, const char* callback, sol::protected_function_result& result) {
+    sol::error err = result;
+    ScriptSandbox::Violation violation = sandbox.getViolation();
+    std::string message = "[LUA ERROR] " + std::string(callback) + " failed in '" + scriptPath + "' (entity " + std::to_string(entity) + "): " + err.what();
+    if (violation != ScriptSandbox::Violation::NONE) {
+        message += " -- script " + std::string(ScriptSandbox::describe(violation)) + " and was suspended";
+    }
+    if (errorLogCallback) {
+        errorLogCallback(message);
+    } else {
+        std::cerr << message << std::endl;
+    }
+    if (violation != ScriptSandbox::Violation::NONE) {
+        suspendScript(entity);
+    }
+}
+
+void ScriptSystem::suspendScript(Entity entity) {
+    ScriptInstance* instance = findInstance(entity);
+    if (!instance || instance->suspended) return;
+    instance->suspended = true;
+    metrics.sandboxViolations++;
+    if (metrics.activeCoroutines > 0) {
+        stopCoroutines(entity);
+    }
+}
+
+void ScriptSystem::resumeSuspendedScripts() {
+    for (ScriptInstance& instance : scriptInstances) {
+        instance.suspended = false;
+        instance.errorReported = false;
+    }
+    for (ScriptInstance& instance : pendingInstances) {
+        instance.suspended = false;
+    }
+    if (workerPool && !workerPool->isRunning()) {
+        workerPool->resumeSuspended();
+    }
+}
+
+void ScriptSystem::setProfilingEnabled(bool enabled) {
+    profiler.setEnabled(enabled);
+    sandbox.setCallHook(enabled ? &ScriptProfiler::onHook : nullptr, &profiler);
+    // Coroutine threads copied the main thread's hook when they were created
+    for (ScriptCoroutine& coroutine : coroutines) {
+        if (coroutine.active) sandbox.applyHook(coroutine.thread.thread_state());
+    }
+}
+
+void ScriptSystem::setSandboxLimits(const ScriptSandbox::Limits& limits) {
+    sandbox.setLimits(limits);
+    if (workerPool && !workerPool->isRunning()) {
+        workerPool->setSandboxLimits(limits);
+    }
+}
+
+template<typename T>
+T* ScriptSystem::resolveComponent(const ComponentRef<T>& ref) {
+    if (ref.entity < MAX_ENTITIES && entityManager->getGeneration(ref.entity) == ref.generation &&
+        componentManager->hasComponent<T>(ref.entity)) {
+        return &componentManager->getComponent<T>(ref.entity);
+    }
+    if (errorLogCallback) {
+        errorLogCallback("[LUA ERROR] Component handle for entity " + std::to_string(ref.entity) + " is no longer valid.");
+    }
+    return nullptr;
+}
+
+template<typename T>
+sol::object ScriptSystem::componentRef(Entity entity, sol::object ComponentRefCache::* slot) {
+    if (entity >= MAX_ENTITIES) return sol::nil;
+    ComponentRefCache& cache = componentRefs[entity];
+    uint32_t generation = entityManager->getGeneration(entity);
+    if (cache.generation != generation) {
+        // The id was reused: handles for the previous entity stay stale, new ones are created
+        cache = ComponentRefCache();
+        cache.generation = generation;
+    }
+    sol::object& ref = cache.*slot;
+    if (!ref.valid()) {
+        ref = sol::make_object(lua, ComponentRef<T>{entity, generation});
+    }
+    return ref;
+}
+
+template<typename T>
+auto ScriptSystem::componentField(float T::* field) {
+    return sol::property(
+        [this, field](const ComponentRef<T>& ref) -> float {
+            T* component = resolveComponent(ref);
+            return component ? component->*field : 0.0f;
+        },
+        [this, field](const ComponentRef<T>& ref, float value) {
+            if (T* component = resolveComponent(ref)) {
+                component->*field = value;
+            }
+        });
+}
+
+void ScriptSystem::registerComponentRefs() {
+    using TransformRef = ComponentRef<TransformComponent>;
+    using VelocityRef = ComponentRef<VelocityComponent>;
+    using ColliderRef = ComponentRef<ColliderComponent>;
+
+    lua.new_usertype<TransformRef>("TransformRef", sol::no_constructor,
+        "valid", sol::property([this](const TransformRef& ref) {
+            return ref.entity < MAX_ENTITIES && entityManager->getGeneration(ref.entity) == ref.generation &&
+                   componentManager->hasComponent<TransformComponent>(ref.entity);
+        }),
+        "entity", sol::readonly(&TransformRef::entity),
+        "x", componentField(&TransformComponent::x),
+        "y", componentField(&TransformComponent::y),
+        "width", componentField(&TransformComponent::width),
+        "height", componentField(&TransformComponent::height),
+        "rotation", componentField(&TransformComponent::rotation)
+    );
+
+    lua.new_usertype<VelocityRef>("VelocityRef", sol::no_constructor,
+        "valid", sol::property([this](const VelocityRef& ref) {
+            return ref.entity < MAX_ENTITIES && entityManager->getGeneration(ref.entity) == ref.generation &&
+                   componentManager->hasComponent<VelocityComponent>(ref.entity);
+        }),
+        "entity", sol::readonly(&VelocityRef::entity),
+        "vx", componentField(&VelocityComponent::vx),
+        "vy", componentField(&VelocityComponent::vy)
+    );
+
+    lua.new_usertype<ColliderRef>("ColliderRef", sol::no_constructor,
+        "valid", sol::property([this](const ColliderRef& ref) {
+            return ref.entity < MAX_ENTITIES && entityManager->getGeneration(ref.entity) == ref.generation &&
+                   componentManager->hasComponent<ColliderComponent>(ref.entity);
+        }),
+        "entity", sol::readonly(&ColliderRef::entity),
+        "count", sol::property([this](const ColliderRef& ref) -> int {
+            ColliderComponent* collider = resolveComponent(ref);
+            return collider ? static_cast<int>(collider->contacts.size()) : 0;
+        }),
+        // 1-based like Lua arrays; returns other entity, normalX, normalY
+        "contact", [this](const ColliderRef& ref, int index) -> std::tuple<Entity, float, float> {
+            ColliderComponent* collider = resolveComponent(ref);
+            if (!collider || index < 1 || index > static_cast<int>(collider->contacts.size())) {
+                return {NO_ENTITY, 0.0f, 0.0f};
+            }
+            const CollisionContact& contact = collider->contacts[index - 1];
+            return {contact.otherEntity, contact.normal.x, contact.normal.y};
+        }
+    );
+
+    registerFunction("GetTransform", [this](Entity entity) -> sol::object {
+        if (!componentManager->hasComponent<TransformComponent>(entity)) return sol::nil;
+        return componentRef<TransformComponent>(entity, &ComponentRefCache::transform);
+    });
+
+    registerFunction("GetVelocity", [this](Entity entity) -> sol::object {
+        if (!componentManager->hasComponent<VelocityComponent>(entity)) return sol::nil;
+        return componentRef<VelocityComponent>(entity, &ComponentRefCache::velocity);
+    });
+
+    registerFunction("GetCollider", [this](Entity entity) -> sol::object {
+        if (!componentManager->hasComponent<ColliderComponent>(entity)) return sol::nil;
+        return componentRef<ColliderComponent>(entity, &ComponentRefCache::collider);
+    });
+}
 
 void ScriptSystem::registerCoreAPI() {
     lua.new_usertype<InputManager>("Input",
@@ -130,18 +1176,45 @@ void ScriptSystem::registerCoreAPI() {
             std::cerr << "[LUA ERROR] " << message << std::endl;
         }
     });
+
+    // Coroutines: wait helpers yield (kind, argument) to the scheduler; kinds match CoroutineWait
+    lua.safe_script(R"(
+        function wait(seconds) return coroutine.yield(1, seconds) end
+        function waitFrames(frames) return coroutine.yield(2, frames) end
+        function waitForEvent(name) return coroutine.yield(3, name) end
+    )");
+
+    registerFunction("StartCoroutine", [this](Entity entity, sol::protected_function function, sol::variadic_args args) {
+        ScriptInstance* instance = findInstance(entity);
+        startCoroutine(entity, instance ? instance->scriptPath : std::string("StartCoroutine"), function, args);
+    });
+
+    registerFunction("StopCoroutines", [this](Entity entity) {
+        stopCoroutines(entity);
+    });
+
+    // Cross-state messaging: on_message(entity, name, value, sender) runs on the target's state next frame
+    registerFunction("PostMessage", [this](Entity sender, Entity target, const std::string& name, sol::object value) {
+        ScriptMessage message;
+        message.sender = sender;
+        message.target = target;
+        message.name = name;
+        message.setValue(value);
+        postMessage(std::move(message));
+    });
 }
 
 void ScriptSystem::registerEntityAPI() {
     lua.new_usertype<Entity>("Entity", sol::constructors<Entity(unsigned int)>());
 
 
-    registerFunction("GetEntityPosition", [this](Entity entity) -> sol::object {
+    // Returns x, y (or nil) without building a table
+    registerFunction("GetEntityPosition", [this](Entity entity) -> std::tuple<sol::optional<float>, sol::optional<float>> {
         if (componentManager->hasComponent<TransformComponent>(entity)) {
             auto& transform = componentManager->getComponent<TransformComponent>(entity);
-            return sol::make_object(lua, sol::as_table(std::vector<float>{transform.x, transform.y}));
+            return {transform.x, transform.y};
         }
-        return sol::nil;
+        return {sol::nullopt, sol::nullopt};
     });
 
     registerFunction("SetEntityPosition", [this](Entity entity, float x, float y) {
@@ -152,6 +1225,64 @@ void ScriptSystem::registerEntityAPI() {
         }
     });
 
+    // Bulk accessors for update_batch scripts: one call reads or writes a whole entity array.
+    // The buffer is a flat table the script keeps between frames: x1, y1, x2, y2, ...
+    registerFunction("GetPositions", [this](sol::table entities, sol::table buffer) -> int {
+        int count = static_cast<int>(entities.size());
+        for (int i = 0; i < count; ++i) {
+            Entity entity = entities.raw_get<Entity>(i + 1);
+            float x = 0.0f, y = 0.0f;
+            if (componentManager->hasComponent<TransformComponent>(entity)) {
+                auto& transform = componentManager->getComponent<TransformComponent>(entity);
+                x = transform.x;
+                y = transform.y;
+            }
+            buffer.raw_set(2 * i + 1, x);
+            buffer.raw_set(2 * i + 2, y);
+        }
+        return count;
+    });
+
+    registerFunction("SetPositions", [this](sol::table entities, sol::table buffer) {
+        int count = static_cast<int>(entities.size());
+        for (int i = 0; i < count; ++i) {
+            Entity entity = entities.raw_get<Entity>(i + 1);
+            if (componentManager->hasComponent<TransformComponent>(entity)) {
+                auto& transform = componentManager->getComponent<TransformComponent>(entity);
+                transform.x = buffer.raw_get<float>(2 * i + 1);
+                transform.y = buffer.raw_get<float>(2 * i + 2);
+            }
+        }
+    });
+
+    registerFunction("GetVelocities", [this](sol::table entities, sol::table buffer) -> int {
+        int count = static_cast<int>(entities.size());
+        for (int i = 0; i < count; ++i) {
+            Entity entity = entities.raw_get<Entity>(i + 1);
+            float vx = 0.0f, vy = 0.0f;
+            if (componentManager->hasComponent<VelocityComponent>(entity)) {
+                auto& velocity = componentManager->getComponent<VelocityComponent>(entity);
+                vx = velocity.vx;
+                vy = velocity.vy;
+            }
+            buffer.raw_set(2 * i + 1, vx);
+            buffer.raw_set(2 * i + 2, vy);
+        }
+        return count;
+    });
+
+    registerFunction("SetVelocities", [this](sol::table entities, sol::table buffer) {
+        int count = static_cast<int>(entities.size());
+        for (int i = 0; i < count; ++i) {
+            Entity entity = entities.raw_get<Entity>(i + 1);
+            if (componentManager->hasComponent<VelocityComponent>(entity)) {
+                auto& velocity = componentManager->getComponent<VelocityComponent>(entity);
+                velocity.vx = buffer.raw_get<float>(2 * i + 1);
+                velocity.vy = buffer.raw_get<float>(2 * i + 2);
+            }
+        }
+    });
+
     registerFunction("MoveEntity", [this](Entity entity, float dx, float dy) {
         if (componentManager->hasComponent<TransformComponent>(entity)) {
             auto& transform = componentManager->getComponent<TransformComponent>(entity);
@@ -160,6 +1291,25 @@ void ScriptSystem::registerEntityAPI() {
         }
     });
 
+    registerFunction("GetTile", [this](Entity entity, int tileX, int tileY) -> int {
+        if (componentManager->hasComponent<TilemapComponent>(entity)) {
+            return componentManager->getComponent<TilemapComponent>(entity).getTile(tileX, tileY);
+        }
+        return TILE_EMPTY;
+    });
+
+    registerFunction("SetTile", [this](Entity entity, int tileX, int tileY, int tileId) {
+        if (!componentManager->hasComponent<TilemapComponent>(entity)) {
+            std::cerr << "[LUA ERROR] SetTile: Entity " << entity << " does not have a TilemapComponent." << std::endl;
+            return;
+        }
+        if (tileId > TILE_MAX_ID) {
+            std::cerr << "[LUA ERROR] SetTile: Tile id " << tileId << " is out of range (max " << TILE_MAX_ID << ")." << std::endl;
+            return;
+        }
+        componentManager->getComponent<TilemapComponent>(entity).setTile(tileX, tileY, tileId);
+    });
+
     registerFunction("SetEntityVelocity", [this](Entity entity, float vx, float vy) {
         if (!componentManager->hasComponent<VelocityComponent>(entity)) {
             std::cerr << "[LUA ERROR] SetEntityVelocity: Entity " << entity << " does not have a VelocityComponent. Cannot set velocity." << std::endl;
@@ -172,13 +1322,13 @@ void ScriptSystem::registerEntityAPI() {
         }
     });
 
-    registerFunction("GetEntityVelocity", [this](Entity entity) -> sol::object {
+    registerFunction("GetEntityVelocity", [this](Entity entity) -> std::tuple<sol::optional<float>, sol::optional<float>> {
         if (componentManager->hasComponent<VelocityComponent>(entity)) {
             auto& velocity = componentManager->getComponent<VelocityComponent>(entity);
-            return sol::make_object(lua, sol::as_table(std::vector<float>{velocity.vx, velocity.vy}));
+            return {velocity.vx, velocity.vy};
         }
         std::cerr << "[LUA ERROR] GetEntityVelocity: Entity " << entity << " does not have a VelocityComponent." << std::endl;
-        return sol::nil;
+        return {sol::nullopt, sol::nullopt};
     });
 
     registerFunction("IsEntityGrounded", [this](Entity entity) -> bool {
@@ -251,19 +1401,10 @@ void ScriptSystem::registerEntityAPI() {
         }
     });
 
+    // Returns the entity's cached collider handle: contacts.count, contacts:contact(i) -> other, normalX, normalY
     registerFunction("GetCollisionContacts", [this](Entity entity) -> sol::object {
         if (componentManager->hasComponent<ColliderComponent>(entity)) {
-            auto& collider = componentManager->getComponent<ColliderComponent>(entity);
-            sol::table contacts_table = lua.create_table();
-            int i = 1;
-            for (const auto& contact : collider.contacts) {
-                sol::table contact_table = lua.create_table();
-                contact_table["otherEntity"] = contact.otherEntity;
-                contact_table["normalX"] = contact.normal.x;
-                contact_table["normalY"] = contact.normal.y;
-                contacts_table[i++] = contact_table;
-            }
-            return contacts_table;
+            return componentRef<ColliderComponent>(entity, &ComponentRefCache::collider);
         }
         if (errorLogCallback) {
             errorLogCallback("[LUA ERROR] GetCollisionContacts: Entity " + std::to_string(entity) + " does not have a ColliderComponent.");
@@ -360,118 +1501,48 @@ void ScriptSystem::registerEntityAPI() {
     });
 
     // Particle System API
-    registerFunction("CreateFireEffect", [this](Entity entity) {
-        if (!componentManager->hasComponent<ParticleEmitterComponent>(entity)) {
-            ParticleEmitterComponent emitter;
-            emitter.emissionRate = 30.0f;
-            emitter.maxParticles = 150;
-            emitter.minLifetime = 0.5f;
-            emitter.maxLifetime = 1.5f;
-            emitter.shape = EmissionShape::CIRCLE;
-            emitter.shapeRadius = 5.0f;
-            emitter.minSpeed = 20.0f;
-            emitter.maxSpeed = 60.0f;
-            emitter.directionAngle = -90.0f;
-            emitter.directionSpread = 30.0f;
-            emitter.gravityY = -20.0f;
-            emitter.damping = 0.95f;
-            emitter.blendMode = ParticleBlendMode::ADDITIVE;
-            emitter.minStartSize = 2.0f;
-            emitter.maxStartSize = 6.0f;
-            emitter.startColor = {255, 100, 0, 255};
-            emitter.endColor = {255, 0, 0, 0};
-            componentManager->addComponent(entity, emitter);
-
-            ParticleComponent particleComp;
-            particleComp.reserveParticles(emitter.maxParticles);
-            componentManager->addComponent(entity, particleComp);
-        }
-    });
-
-    registerFunction("CreateExplosionEffect", [this](Entity entity) {
-        if (!componentManager->hasComponent<ParticleEmitterComponent>(entity)) {
-            ParticleEmitterComponent emitter;
-            emitter.emissionRate = 200.0f;
-            emitter.maxParticles = 100;
-            emitter.minLifetime = 0.3f;
-            emitter.maxLifetime = 1.0f;
-            emitter.shape = EmissionShape::POINT;
-            emitter.minSpeed = 100.0f;
-            emitter.maxSpeed = 300.0f;
-            emitter.directionAngle = 0.0f;
-            emitter.directionSpread = 360.0f;
-            emitter.gravityY = 200.0f;
-            emitter.damping = 0.9f;
-            emitter.blendMode = ParticleBlendMode::ADDITIVE;
-            emitter.minStartSize = 3.0f;
-            emitter.maxStartSize = 8.0f;
-            emitter.startColor = {255, 255, 100, 255};
-            emitter.endColor = {255, 50, 0, 0};
-            emitter.looping = false;
-            emitter.duration = 0.2f;
-            componentManager->addComponent(entity, emitter);
-
-            ParticleComponent particleComp;
-            particleComp.reserveParticles(emitter.maxParticles);
-            componentManager->addComponent(entity, particleComp);
-        }
-    });
-
-    registerFunction("CreateSmokeEffect", [this](Entity entity) {
-        if (!componentManager->hasComponent<ParticleEmitterComponent>(entity)) {
-            ParticleEmitterComponent emitter;
-            emitter.emissionRate = 15.0f;
-            emitter.maxParticles = 80;
-            emitter.minLifetime = 2.0f;
-            emitter.maxLifetime = 4.0f;
-            emitter.shape = EmissionShape::CIRCLE;
-            emitter.shapeRadius = 8.0f;
-            emitter.minSpeed = 10.0f;
-            emitter.maxSpeed = 30.0f;
-            emitter.directionAngle = -90.0f;
-            emitter.directionSpread = 20.0f;
-            emitter.gravityY = -10.0f;
-            emitter.damping = 0.98f;
-            emitter.blendMode = ParticleBlendMode::ALPHA;
-            emitter.minStartSize = 4.0f;
-            emitter.maxStartSize = 8.0f;
-            emitter.startColor = {100, 100, 100, 150};
-            emitter.endColor = {200, 200, 200, 0};
-            componentManager->addComponent(entity, emitter);
-
-            ParticleComponent particleComp;
-            particleComp.reserveParticles(emitter.maxParticles);
-            componentManager->addComponent(entity, particleComp);
-        }
-    });
-
-    registerFunction("CreateSparkleEffect", [this](Entity entity) {
-        if (!componentManager->hasComponent<ParticleEmitterComponent>(entity)) {
-            ParticleEmitterComponent emitter;
-            emitter.emissionRate = 20.0f;
-            emitter.maxParticles = 60;
-            emitter.minLifetime = 1.0f;
-            emitter.maxLifetime = 2.0f;
-            emitter.shape = EmissionShape::CIRCLE;
-            emitter.shapeRadius = 15.0f;
-            emitter.minSpeed = 5.0f;
-            emitter.maxSpeed = 25.0f;
-            emitter.directionAngle = 0.0f;
-            emitter.directionSpread = 360.0f;
-            emitter.gravityY = 0.0f;
-            emitter.damping = 0.99f;
-            emitter.blendMode = ParticleBlendMode::ADDITIVE;
-            emitter.minStartSize = 1.0f;
-            emitter.maxStartSize = 3.0f;
-            emitter.startColor = {255, 255, 255, 255};
-            emitter.endColor = {255, 255, 100, 0};
-            emitter.minRotationSpeed = -180.0f;
-            emitter.maxRotationSpeed = 180.0f;
-            componentManager->addComponent(entity, emitter);
-
-            ParticleComponent particleComp;
-            particleComp.reserveParticles(emitter.maxParticles);
-            componentManager->addComponent(entity, particleComp);
+    // Preset emitters come from the particle system, which also keeps system membership in sync
+    auto attachEffect = [this](Entity entity, const std::string& presetName, const char* functionName) {
+        if (componentManager->hasComponent<ParticleEmitterComponent>(entity)) return;
+        if (!particleSystem) {
+            if (errorLogCallback) {
+                errorLogCallback(std::string("[LUA ERROR] ") + functionName + ": particle system is not available.");
+            }
+            return;
+        }
+        particleSystem->attachPreset(entity, componentManager, presetName);
+    };
+
+    registerFunction("CreateFireEffect", [attachEffect](Entity entity) {
+        attachEffect(entity, "fire", "CreateFireEffect");
+    });
+
+    registerFunction("CreateExplosionEffect", [attachEffect](Entity entity) {
+        attachEffect(entity, "explosion", "CreateExplosionEffect");
+    });
+
+    registerFunction("CreateSmokeEffect", [attachEffect](Entity entity) {
+        attachEffect(entity, "smoke", "CreateSmokeEffect");
+    });
+
+    registerFunction("CreateSparkleEffect", [attachEffect](Entity entity) {
+        attachEffect(entity, "sparkle", "CreateSparkleEffect");
+    });
+
+    // Pooled one-shot effects: SpawnParticleEffect("explosion", x, y) reuses finished effect entities
+    registerFunction("SpawnParticleEffect", [this](const std::string& presetName, float x, float y, sol::optional<bool> prewarmOpt) -> Entity {
+        if (!particleSystem || !particleSystem->hasPreset(presetName)) {
+            if (errorLogCallback) {
+                errorLogCallback("[LUA ERROR] SpawnParticleEffect: Unknown particle preset '" + presetName + "'.");
+            }
+            return NO_ENTITY;
+        }
+        return particleSystem->spawnEffect(presetName, x, y, prewarmOpt.value_or(false));
+    });
+
+    registerFunction("StopParticleEffect", [this](Entity entity) {
+        if (particleSystem) {
+            particleSystem->stopEffect(entity);
         }
     });
 
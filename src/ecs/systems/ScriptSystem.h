@@ -1,14 +1,26 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <unordered_map>
+#include <filesystem>
+#include <queue>
+#include <deque>
+#include <memory>
+#include <future>
 #include "../System.h"
 #include "../Entity.h"
+#include "EventSystem.h"
+#include "ScriptWorkerPool.h"
+#include "ScriptSandbox.h"
+#include "ScriptProfiler.h"
+#include "../../utils/FileWatcher.h"
 #include <sol/sol.hpp> 
 #include <functional> 
 
 class EntityManager;
 class ComponentManager;
+class ParticleSystem;
 
 class ScriptSystem : public System {
 public:
@@ -20,6 +32,11 @@ public:
     void update(float deltaTime);
 
     bool loadScript(Entity entity, const std::string& scriptPath);
+    void unloadScript(Entity entity);
+    bool hasScript(Entity entity) const;
+
+    // An entity leaving the system (ScriptComponent removed or entity destroyed) drops its script
+    void removeEntity(Entity entity) override;
 
     template<typename... Args>
     sol::protected_function_result callScriptFunction(Entity entity, const std::string& functionName, Args&&... args);
@@ -28,18 +45,279 @@ public:
     void registerFunction(const std::string& luaName, Func&& f);
     
     sol::state& getLuaState() { return lua; }
+    
+    // Particle effects from scripts go through the particle system's effect pool
+    void setParticleSystem(ParticleSystem* system) { particleSystem = system; }
+
+    // Coroutines blocked in waitForEvent(name) are woken from the event system's dispatched frame
+    void setEventSystem(EventSystem* system) { eventSystem = system; }
+
+    // Stops every coroutine started for the entity (also done when its script is unloaded)
+    void stopCoroutines(Entity entity);
+
+    // Parallel scripts: with a non-zero count, modules that set `parallel = true` run on that many
+    // worker Lua states in parallel with the main state. Changing the count reloads them.
+    void setWorkerCount(int count);
+    int getWorkerCount() const { return workerPool ? workerPool->getWorkerCount() : 0; }
+    std::vector<ScriptWorkerPool::WorkerMetrics> getWorkerMetrics() const;
+
+    // Hot reload: loaded script files are watched, recompiled off the main thread when they change
+    // and swapped in at the start of the next update. Module functions are replaced in place, so
+    // per-entity state tables survive; a script that fails to compile or run keeps its old version.
+    void setHotReloadEnabled(bool enabled) { hotReloadEnabled = enabled; }
+    bool isHotReloadEnabled() const { return hotReloadEnabled; }
+
+    // Sandbox: every script callback runs with an instruction budget and the state has a memory cap.
+    // A script that hits either limit is suspended (its update, messages and coroutines stop) and
+    // reported, until it is resumed or its file is hot-reloaded. Applies to worker states as well.
+    void setSandboxLimits(const ScriptSandbox::Limits& limits);
+    const ScriptSandbox::Limits& getSandboxLimits() const { return sandbox.getLimits(); }
+    void resumeSuspendedScripts();
+
+    // Profiling: attributes the main state's script time, calls and allocations to script files,
+    // entities and Lua functions (see ScriptProfiler). Off by default; it costs nothing while off.
+    void setProfilingEnabled(bool enabled);
+    bool isProfilingEnabled() const { return profiler.isEnabled(); }
+    ScriptProfiler& getProfiler() { return profiler; }
+
+    // Garbage collection is driven from update(): Lua's automatic collector is stopped and the
+    // collector is stepped at the end of the script phase until the frame budget is used up
+    struct GCSettings {
+        bool budgeted = true;          // false: Lua collects on its own, as by default
+        bool generational = false;     // Lua 5.4 generational mode instead of incremental
+        float stepBudgetMs = 1.0f;     // Time spent stepping the collector per frame
+        int stepSizeKB = 16;           // Work done per collector step
+        int emergencyHeapMB = 256;     // Above this the budget is ignored and a full collection runs
+        int incrementalPause = 200;
+        int incrementalStepMultiplier = 100;
+        int generationalMinorMultiplier = 20;
+        int generationalMajorMultiplier = 100;
+    };
+
+    void setGCSettings(const GCSettings& settings);
+    const GCSettings& getGCSettings() const { return gcSettings; }
+
+    // Performance metrics
+    struct PerformanceMetrics {
+        float updateTime = 0.0f;       // Script callbacks, excluding GC
+        float gcStepTime = 0.0f;
+        int gcSteps = 0;
+        int gcCyclesCompleted = 0;     // Cumulative
+        int gcEmergencyCollections = 0;    // Cumulative
+        size_t heapBytes = 0;
+        size_t peakHeapBytes = 0;
+        size_t collectedBytes = 0;     // Freed by this frame's GC steps
+        int scriptInstances = 0;
+        int activeCoroutines = 0;
+        int coroutinesResumed = 0;     // This frame
+        int workerEntities = 0;
+        float workerWaitTime = 0.0f;   // Main thread blocked on workers after its own scripts
+        int workerCommands = 0;
+        int messagesDelivered = 0;
+        int scriptsReloaded = 0;       // Cumulative
+        int reloadFailures = 0;        // Cumulative; the previous version was kept
+        int suspendedScripts = 0;
+        int sandboxViolations = 0;     // Cumulative
+    };
+
+    const PerformanceMetrics& getMetrics() const { return metrics; }
+    void resetMetrics();
 
 private:
     EntityManager* entityManager;
     ComponentManager* componentManager;
+    ParticleSystem* particleSystem = nullptr;
+    ScriptSandbox sandbox;            // Declared before the state: it is the state's allocator
+    ScriptProfiler profiler{sandbox}; // and these two receive its hook calls
     sol::state lua;
     std::function<void(const std::string&)> logCallback;
     std::function<void(const std::string&)> errorLogCallback;
 
-    std::unordered_map<Entity, sol::environment> entityScriptEnvironments;
+    struct ScriptModule;
+
+    // One loaded script per entity, stored densely so update() walks the array directly.
+    // Lifecycle callbacks are resolved once at load time rather than looked up by name per call.
+    struct ScriptInstance {
+        Entity entity = NO_ENTITY;
+        std::string scriptPath;
+        sol::environment env;
+        sol::protected_function init;
+        sol::protected_function update;
+        bool shared = false;          // Module script: callbacks come from the shared module table
+        sol::table state;             // Module script: per-entity `self`, passed as first argument
+        ScriptModule* batch = nullptr; // Module with update_batch: updated together with its module
+        bool removed = false;         // Unloaded while scripts were running; compacted afterwards
+        bool errorReported = false;   // update() errors are reported once per load
+        bool suspended = false;       // Stopped by a sandbox limit
+    };
+
+    std::vector<ScriptInstance> scriptInstances;
+    std::vector<int> instanceSlots;   // Per entity: index into scriptInstances, -1 if none
+    bool updatingScripts = false;
+    std::vector<ScriptInstance> pendingInstances;
+
+    // Script files are compiled once and cached as bytecode. A script that returns a table is a
+    // module: it runs once, and each entity gets a small state table whose metatable indexes the
+    // module. Other scripts still run per entity (from the cached bytecode) for their own globals.
+    struct ScriptModule {
+        std::string scriptPath;
+        std::string bytecode;
+        std::filesystem::file_time_type writeTime;
+        bool probed = false;          // Executed once, so we know whether it is a module
+        bool shared = false;
+        bool parallel = false;        // Module asked to run on a worker state
+        sol::table table;
+        sol::table instanceMetatable;
+
+        // Modules that define update_batch(entities, dt) are called once per frame with every
+        // entity running them, instead of once per entity. The entity array is reused each frame.
+        sol::protected_function updateBatch;
+        sol::table batchEntities;
+        size_t batchTableSize = 0;
+        std::vector<Entity> batchMembers;
+        bool batchListed = false;
+        bool batchErrorReported = false;
+    };
+    std::unordered_map<std::string, ScriptModule> scriptModules;   // Node-based: pointers stay valid
+    std::vector<ScriptModule*> batchedModules;
+
+    ScriptModule* acquireModule(const std::string& scriptPath);
+    bool instantiateScript(ScriptModule& module, ScriptInstance& instance);
+    // Lists the module for batched updates if it defines update_batch, unlists it otherwise
+    void setModuleBatch(ScriptModule& module, const sol::protected_function& updateBatch);
+    void runBatchedModules(float deltaTime);
+
+    // Per-entity coroutines. A coroutine that yields through wait(seconds), waitFrames(n) or
+    // waitForEvent(name) is parked in a queue and not touched again until it is due.
+    enum class CoroutineWait : std::uint8_t {
+        NONE,
+        TIME,
+        FRAMES,
+        EVENT
+    };
+
+    struct ScriptCoroutine {
+        Entity entity = NO_ENTITY;
+        std::string scriptPath;
+        sol::thread thread;
+        sol::coroutine routine;
+        std::uint32_t serial = 0;     // Bumped on every wait and on stop; stale queue entries are skipped
+        bool active = false;
+        bool running = false;         // Being resumed; its thread is on the C stack
+        bool stopping = false;        // Stopped while running; released once the resume returns
+    };
+
+    struct CoroutineWake {
+        double due;                   // Script time in seconds, or a frame number
+        std::uint32_t slot;
+        std::uint32_t serial;
+        bool operator>(const CoroutineWake& other) const { return due > other.due; }
+    };
+    using WakeQueue = std::priority_queue<CoroutineWake, std::vector<CoroutineWake>, std::greater<CoroutineWake>>;
+
+    std::deque<ScriptCoroutine> coroutines;   // Deque: a running coroutine may start others without moving itself
+    std::vector<std::uint32_t> freeCoroutineSlots;
+    WakeQueue timeWakes;
+    WakeQueue frameWakes;
+    std::unordered_map<EventNameId, std::vector<CoroutineWake>> eventWakes;
+    size_t eventWaiters = 0;
+    struct DueCoroutine {
+        std::uint32_t slot;
+        bool fromEvent;
+        Entity sender;                // Passed back from waitForEvent
+    };
+    std::vector<DueCoroutine> dueCoroutines;
+    double scriptTime = 0.0;
+    std::uint64_t scriptFrame = 0;
+    EventSystem* eventSystem = nullptr;
+    EventSystem::EventCursor eventCursor;
+
+    std::uint32_t createCoroutine(Entity entity, const std::string& scriptPath, const sol::protected_function& function);
+    template<typename... Args>
+    void startCoroutine(Entity entity, const std::string& scriptPath, const sol::protected_function& function, Args&&... args);
+    void resumeDueCoroutines();
+    void scheduleCoroutine(std::uint32_t slot, sol::protected_function_result& result);
+    void releaseCoroutine(std::uint32_t slot);
+
+    std::unique_ptr<ScriptWorkerPool> workerPool;
+    ScriptSnapshot workerSnapshot;
+    std::vector<ScriptCommand> workerCommands;
+    std::vector<ScriptMessage> mainInbox;          // For main-state scripts, delivered next frame
+    std::vector<ScriptMessage> deliveringMessages;
+    std::vector<ScriptMessage> pendingWorkerMessages;
+    std::vector<std::pair<Entity, std::string>> pendingWorkerLoads;   // Requested while workers ran
+    std::vector<Entity> pendingWorkerUnloads;
+
+    void buildWorkerSnapshot();
+    void applyWorkerCommands();
+    void deliverMessages();
+    void postMessage(ScriptMessage&& message);
+    void applyPendingWorkerChanges();
+    bool loadOnWorker(Entity entity, const std::string& scriptPath, ScriptModule& module);
+
+    struct ScriptCompileResult {
+        bool success = false;
+        std::string bytecode;
+        std::string error;
+        std::filesystem::file_time_type writeTime;
+    };
+
+    struct ScriptCompileJob {
+        std::string scriptPath;
+        std::future<ScriptCompileResult> result;
+    };
+
+    bool hotReloadEnabled = false;
+    FileWatcher scriptWatcher;
+    std::vector<std::string> changedScripts;
+    std::vector<ScriptCompileJob> compileJobs;
+
+    static ScriptCompileResult compileScriptFile(const std::string& scriptPath);
+    void pollScriptChanges();
+    void applyCompiledScript(const std::string& scriptPath, const ScriptCompileResult& compiled);
+    bool reloadModule(const std::string& scriptPath, const ScriptCompileResult& compiled);
+
+    GCSettings gcSettings;
+    PerformanceMetrics metrics;
+
+    void applyGCSettings();
+    void stepGarbageCollector();
+    size_t luaHeapBytes();
+
+    ScriptInstance* findInstance(Entity entity);
+    void addInstance(ScriptInstance&& instance);
+    void compactInstances();
+    void reportScriptError(Entity entity, const std::string& scriptPath, const char* callback, sol::protected_function_result& result);
+    void suspendScript(Entity entity);
+
+    // Component handles given to scripts. A handle names an entity and the generation it was
+    // created for, and resolves the component on every access, so it never dangles when components
+    // move or the entity id is reused. One handle per entity and component is created and cached,
+    // so scripts reading state every frame do not allocate.
+    template<typename T>
+    struct ComponentRef {
+        Entity entity = NO_ENTITY;
+        uint32_t generation = 0;
+    };
+
+    struct ComponentRefCache {
+        uint32_t generation = 0;
+        sol::object transform;
+        sol::object velocity;
+        sol::object collider;
+    };
+    std::vector<ComponentRefCache> componentRefs;   // Indexed by entity
+
+    template<typename T>
+    T* resolveComponent(const ComponentRef<T>& ref);
+    template<typename T>
+    sol::object componentRef(Entity entity, sol::object ComponentRefCache::* slot);
+    template<typename T>
+    auto componentField(float T::* field);
 
     void registerCoreAPI(); 
     void registerEntityAPI(); 
+    void registerComponentRefs();
 };
 
 template<typename Func>
@@ -47,14 +325,32 @@ void ScriptSystem::registerFunction(const std::string& luaName, Func&& f) {
     lua.set_function(luaName, std::forward<Func>(f));
 }
 
+template<typename... Args>
+void ScriptSystem::startCoroutine(Entity entity, const std::string& scriptPath, const sol::protected_function& function, Args&&... args) {
+    std::uint32_t slot = createCoroutine(entity, scriptPath, function);
+    ScriptCoroutine& coroutine = coroutines[slot];
+    ScriptSandbox::Scope scope(sandbox);
+    ScriptProfiler::Scope profile(profiler, entity, scriptPath, "coroutine");
+    coroutine.running = true;
+    sol::protected_function_result result = coroutine.routine(std::forward<Args>(args)...);
+    scheduleCoroutine(slot, result);
+}
+
 template<typename... Args>
 sol::protected_function_result ScriptSystem::callScriptFunction(Entity entity, const std::string& functionName, Args&&... args) {
-    auto it = entityScriptEnvironments.find(entity);
-    if (it != entityScriptEnvironments.end()) {
-        sol::environment& env = it->second;
-        sol::protected_function func = env[functionName];
-        if (func.valid()) {
-            return func(std::forward<Args>(args)...);
+    if (ScriptInstance* instance = findInstance(entity); instance && !instance->suspended) {
+        ScriptSandbox::Scope scope(sandbox);
+        ScriptProfiler::Scope profile(profiler, entity, instance->scriptPath, functionName.c_str());
+        if (instance->shared) {
+            sol::protected_function func = instance->state[functionName];
+            if (func.valid()) {
+                return func(instance->state, std::forward<Args>(args)...);
+            }
+        } else {
+            sol::protected_function func = instance->env[functionName];
+            if (func.valid()) {
+                return func(std::forward<Args>(args)...);
+            }
         }
     }
     sol::protected_function_result result; 
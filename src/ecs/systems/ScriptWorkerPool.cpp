@@ -0,0 +1,338 @@
+#include "ScriptWorkerPool.h"
+#include <chrono>
+#include <algorithm>
+
+ScriptWorkerPool::ScriptWorkerPool(int workerCount)
+    : owner(MAX_ENTITIES, -1), entityCounts(std::max(workerCount, 1), 0) {
+    for (int i = 0; i < std::max(workerCount, 1); ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->index = i;
+        worker->slots.assign(MAX_ENTITIES, -1);
+        worker->sandbox.attach(worker->lua.lua_state());
+        worker->lua.open_libraries(sol::lib::base, sol::lib::string, sol::lib::math, sol::lib::table);
+        ScriptSandbox::hardenLibraries(worker->lua);
+        registerWorkerAPI(*worker);
+        workers.push_back(std::move(worker));
+    }
+    for (auto& worker : workers) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w]() { workerLoop(*w); });
+    }
+}
+
+ScriptWorkerPool::~ScriptWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    startCondition.notify_all();
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+void ScriptWorkerPool::registerWorkerAPI(Worker& worker) {
+    Worker* w = &worker;
+    sol::state& lua = worker.lua;
+
+    // Reads come from the frame's snapshot
+    lua.set_function("GetEntityPosition", [this](Entity entity) -> std::tuple<sol::optional<float>, sol::optional<float>> {
+        if (!snapshot || entity >= MAX_ENTITIES || !snapshot->entries[entity].hasTransform) return {sol::nullopt, sol::nullopt};
+        const ScriptSnapshot::Entry& entry = snapshot->entries[entity];
+        return {entry.x, entry.y};
+    });
+    lua.set_function("GetEntityVelocity", [this](Entity entity) -> std::tuple<sol::optional<float>, sol::optional<float>> {
+        if (!snapshot || entity >= MAX_ENTITIES || !snapshot->entries[entity].hasVelocity) return {sol::nullopt, sol::nullopt};
+        const ScriptSnapshot::Entry& entry = snapshot->entries[entity];
+        return {entry.vx, entry.vy};
+    });
+    lua.set_function("GetWorkerIndex", [w]() { return w->index; });
+
+    // Writes are recorded and applied by the main thread after the frame
+    lua.set_function("SetEntityPosition", [w](Entity entity, float x, float y) {
+        w->commands.push_back({ScriptCommand::Type::SET_POSITION, entity, x, y, {}});
+    });
+    lua.set_function("MoveEntity", [w](Entity entity, float dx, float dy) {
+        w->commands.push_back({ScriptCommand::Type::MOVE, entity, dx, dy, {}});
+    });
+    lua.set_function("SetEntityVelocity", [w](Entity entity, float vx, float vy) {
+        w->commands.push_back({ScriptCommand::Type::SET_VELOCITY, entity, vx, vy, {}});
+    });
+    lua.set_function("SendEvent", [w](Entity entity, const std::string& eventName) {
+        w->commands.push_back({ScriptCommand::Type::SEND_EVENT, entity, 0.0f, 0.0f, eventName});
+    });
+    lua.set_function("Log", [w](const std::string& message) {
+        w->commands.push_back({ScriptCommand::Type::LOG, NO_ENTITY, 0.0f, 0.0f, message});
+    });
+    lua.set_function("LogError", [w](const std::string& message) {
+        w->commands.push_back({ScriptCommand::Type::LOG_ERROR, NO_ENTITY, 0.0f, 0.0f, message});
+    });
+
+    lua.set_function("PostMessage", [w](Entity sender, Entity target, const std::string& name, sol::object value) {
+        ScriptMessage message;
+        message.sender = sender;
+        message.target = target;
+        message.name = name;
+        message.setValue(value);
+        w->outbox.push_back(std::move(message));
+    });
+}
+
+bool ScriptWorkerPool::addEntity(Entity entity, const std::string& scriptPath, const std::string& bytecode) {
+    if (entity >= MAX_ENTITIES || running) return false;
+    removeEntity(entity);
+
+    // Keep partitions balanced by entity count
+    int index = static_cast<int>(std::min_element(entityCounts.begin(), entityCounts.end()) - entityCounts.begin());
+    Worker& worker = *workers[index];
+
+    auto moduleIt = worker.modules.find(scriptPath);
+    if (moduleIt == worker.modules.end()) {
+        sol::load_result chunk = worker.lua.load(bytecode, "@" + scriptPath, sol::load_mode::binary);
+        if (!chunk.valid()) {
+            sol::error err = chunk;
+            worker.commands.push_back({ScriptCommand::Type::LOG_ERROR, entity, 0.0f, 0.0f,
+                "Worker " + std::to_string(index) + " failed to load '" + scriptPath + "': " + err.what()});
+            return false;
+        }
+        sol::protected_function moduleChunk = chunk;
+        ScriptSandbox::Scope scope(worker.sandbox);
+        sol::protected_function_result result = moduleChunk();
+        if (!result.valid() || result.get_type() != sol::type::table) {
+            worker.commands.push_back({ScriptCommand::Type::LOG_ERROR, entity, 0.0f, 0.0f,
+                "Worker " + std::to_string(index) + ": '" + scriptPath + "' did not return a module table"});
+            return false;
+        }
+        WorkerModule module;
+        module.table = result;
+        module.instanceMetatable = worker.lua.create_table();
+        module.instanceMetatable["__index"] = module.table;
+        moduleIt = worker.modules.emplace(scriptPath, std::move(module)).first;
+    }
+
+    WorkerInstance instance;
+    instance.entity = entity;
+    instance.scriptPath = scriptPath;
+    instance.state = worker.lua.create_table();
+    instance.state["entity"] = entity;
+    instance.state[sol::metatable_key] = moduleIt->second.instanceMetatable;
+    sol::protected_function init = moduleIt->second.table["init"];
+    sol::protected_function update = moduleIt->second.table["update"];
+    sol::protected_function onMessage = moduleIt->second.table["on_message"];
+    instance.update = update;
+    instance.onMessage = onMessage;
+
+    worker.slots[entity] = static_cast<int>(worker.instances.size());
+    worker.instances.push_back(std::move(instance));
+    owner[entity] = index;
+    entityCounts[index]++;
+
+    if (init.valid()) {
+        WorkerInstance& added = worker.instances.back();
+        ScriptSandbox::Scope scope(worker.sandbox);
+        sol::protected_function_result result = init(added.state, entity);
+        if (!result.valid()) {
+            reportError(worker, entity, scriptPath, "init", result);
+        }
+    }
+    return true;
+}
+
+void ScriptWorkerPool::removeEntity(Entity entity) {
+    if (!owns(entity) || running) return;
+    Worker& worker = *workers[owner[entity]];
+    int slot = worker.slots[entity];
+    size_t last = worker.instances.size() - 1;
+    if (static_cast<size_t>(slot) != last) {
+        worker.instances[slot] = std::move(worker.instances[last]);
+        worker.slots[worker.instances[slot].entity] = slot;
+    }
+    worker.instances.pop_back();
+    worker.slots[entity] = -1;
+    entityCounts[owner[entity]]--;
+    owner[entity] = -1;
+}
+
+int ScriptWorkerPool::getEntityCount() const {
+    int count = 0;
+    for (int entities : entityCounts) count += entities;
+    return count;
+}
+
+std::vector<std::pair<Entity, std::string>> ScriptWorkerPool::getEntities() const {
+    std::vector<std::pair<Entity, std::string>> result;
+    for (const auto& worker : workers) {
+        for (const auto& instance : worker->instances) {
+            result.emplace_back(instance.entity, instance.scriptPath);
+        }
+    }
+    return result;
+}
+
+void ScriptWorkerPool::reloadModule(const std::string& scriptPath, const std::string& bytecode) {
+    if (running) return;
+    for (auto& worker : workers) {
+        auto moduleIt = worker->modules.find(scriptPath);
+        if (moduleIt == worker->modules.end()) continue;
+
+        sol::load_result chunk = worker->lua.load(bytecode, "@" + scriptPath, sol::load_mode::binary);
+        if (!chunk.valid()) continue; // Compiled by the main state already; only fails on memory errors
+        sol::protected_function moduleChunk = chunk;
+        ScriptSandbox::Scope scope(worker->sandbox);
+        sol::protected_function_result result = moduleChunk();
+        if (!result.valid() || result.get_type() != sol::type::table) {
+            worker->commands.push_back({ScriptCommand::Type::LOG_ERROR, NO_ENTITY, 0.0f, 0.0f,
+                "Worker " + std::to_string(worker->index) + " kept the previous version of '" + scriptPath + "': reload did not return a module table"});
+            continue;
+        }
+        sol::table fresh = result;
+        replaceTableContents(moduleIt->second.table, fresh);
+
+        sol::protected_function update = moduleIt->second.table["update"];
+        sol::protected_function onMessage = moduleIt->second.table["on_message"];
+        for (WorkerInstance& instance : worker->instances) {
+            if (instance.scriptPath != scriptPath) continue;
+            instance.update = update;
+            instance.onMessage = onMessage;
+            instance.errorReported = false;
+            instance.suspended = false;
+        }
+    }
+}
+
+void ScriptWorkerPool::setSandboxLimits(const ScriptSandbox::Limits& limits) {
+    if (running) return;
+    for (auto& worker : workers) {
+        worker->sandbox.setLimits(limits);
+    }
+}
+
+void ScriptWorkerPool::resumeSuspended() {
+    if (running) return;
+    for (auto& worker : workers) {
+        for (WorkerInstance& instance : worker->instances) {
+            instance.suspended = false;
+            instance.errorReported = false;
+        }
+    }
+}
+
+bool ScriptWorkerPool::postMessage(ScriptMessage&& message) {
+    if (!owns(message.target)) return false;
+    workers[owner[message.target]]->inbox.push_back(std::move(message));
+    return true;
+}
+
+void ScriptWorkerPool::beginFrame(const ScriptSnapshot* frameSnapshot, float deltaTime) {
+    if (running) return;
+    snapshot = frameSnapshot;
+    frameDeltaTime = deltaTime;
+    running = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        workersBusy = static_cast<int>(workers.size());
+        ++frameGeneration;
+    }
+    startCondition.notify_all();
+}
+
+void ScriptWorkerPool::endFrame(std::vector<ScriptCommand>& commands, std::vector<ScriptMessage>& outgoing) {
+    if (running) {
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [this]() { return workersBusy == 0; });
+        running = false;
+    }
+
+    // Worker order keeps the result independent of which thread finished first
+    for (auto& worker : workers) {
+        for (auto& command : worker->commands) {
+            commands.push_back(std::move(command));
+        }
+        worker->commands.clear();
+    }
+    for (auto& worker : workers) {
+        for (auto& message : worker->outbox) {
+            if (owns(message.target)) {
+                workers[owner[message.target]]->inbox.push_back(std::move(message));
+            } else {
+                outgoing.push_back(std::move(message));
+            }
+        }
+        worker->outbox.clear();
+    }
+    snapshot = nullptr;
+}
+
+std::vector<ScriptWorkerPool::WorkerMetrics> ScriptWorkerPool::getMetrics() const {
+    std::vector<WorkerMetrics> result;
+    for (const auto& worker : workers) {
+        WorkerMetrics metrics = worker->metrics;
+        metrics.entities = static_cast<int>(worker->instances.size());
+        metrics.suspended = static_cast<int>(std::count_if(worker->instances.begin(), worker->instances.end(),
+            [](const WorkerInstance& instance) { return instance.suspended; }));
+        result.push_back(metrics);
+    }
+    return result;
+}
+
+void ScriptWorkerPool::workerLoop(Worker& worker) {
+    std::uint64_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            startCondition.wait(lock, [&]() { return stopping || frameGeneration != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = frameGeneration;
+        }
+
+        runWorker(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--workersBusy == 0) doneCondition.notify_one();
+        }
+    }
+}
+
+void ScriptWorkerPool::runWorker(Worker& worker) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    for (ScriptMessage& message : worker.inbox) {
+        if (message.target >= MAX_ENTITIES || worker.slots[message.target] < 0) continue;
+        WorkerInstance& instance = worker.instances[worker.slots[message.target]];
+        if (instance.suspended || !instance.onMessage.valid()) continue;
+
+        ScriptSandbox::Scope scope(worker.sandbox);
+        sol::protected_function_result result = instance.onMessage(instance.state, instance.entity, message.name, message.getValue(worker.lua), message.sender);
+        if (!result.valid()) {
+            reportError(worker, instance.entity, instance.scriptPath, "on_message", result);
+        }
+    }
+    worker.inbox.clear();
+
+    for (WorkerInstance& instance : worker.instances) {
+        if (instance.suspended || !instance.update.valid()) continue;
+        ScriptSandbox::Scope scope(worker.sandbox);
+        sol::protected_function_result result = instance.update(instance.state, instance.entity, frameDeltaTime);
+        if (!result.valid() && (!instance.errorReported || worker.sandbox.getViolation() != ScriptSandbox::Violation::NONE)) {
+            instance.errorReported = true;
+            reportError(worker, instance.entity, instance.scriptPath, "update", result);
+        }
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    worker.metrics.updateTime = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+}
+
+void ScriptWorkerPool::reportError(Worker& worker, Entity entity, const std::string& scriptPath, const char* callback, sol::protected_function_result& result) {
+    sol::error err = result;
+    std::string message = std::string(callback) + " failed in '" + scriptPath + "' (entity " + std::to_string(entity) +
+        ", worker " + std::to_string(worker.index) + "): " + err.what();
+
+    ScriptSandbox::Violation violation = worker.sandbox.getViolation();
+    if (violation != ScriptSandbox::Violation::NONE && entity < MAX_ENTITIES && worker.slots[entity] >= 0) {
+        worker.instances[worker.slots[entity]].suspended = true;
+        message += " -- script " + std::string(ScriptSandbox::describe(violation)) + " and was suspended";
+    }
+    worker.commands.push_back({ScriptCommand::Type::LOG_ERROR, entity, 0.0f, 0.0f, message});
+}
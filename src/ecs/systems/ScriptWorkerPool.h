@@ -0,0 +1,193 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <unordered_map>
+#include "../Entity.h"
+#include "ScriptSandbox.h"
+#include <sol/sol.hpp>
+
+// Read-only copy of the component state worker scripts may look at, taken before they run
+struct ScriptSnapshot {
+    struct Entry {
+        bool hasTransform = false;
+        bool hasVelocity = false;
+        float x = 0.0f;
+        float y = 0.0f;
+        float vx = 0.0f;
+        float vy = 0.0f;
+    };
+    std::vector<Entry> entries = std::vector<Entry>(MAX_ENTITIES);
+};
+
+// Component writes and other side effects requested by worker scripts. They are applied on the
+// main thread after every worker has finished, worker by worker, so results are deterministic.
+struct ScriptCommand {
+    enum class Type : std::uint8_t {
+        SET_POSITION,
+        MOVE,
+        SET_VELOCITY,
+        SEND_EVENT,
+        LOG,
+        LOG_ERROR
+    };
+    Type type;
+    Entity entity = NO_ENTITY;
+    float x = 0.0f;
+    float y = 0.0f;
+    std::string text;
+};
+
+// Cross-state message. Lua values cannot move between states, so a message carries a name and
+// one plain value. Messages posted during a frame are delivered to on_message at the next one.
+struct ScriptMessage {
+    enum class ValueType : std::uint8_t {
+        NONE,
+        NUMBER,
+        BOOLEAN,
+        TEXT
+    };
+    Entity target = NO_ENTITY;
+    Entity sender = NO_ENTITY;
+    std::string name;
+    ValueType valueType = ValueType::NONE;
+    double number = 0.0;
+    std::string text;
+
+    // Tables, functions and userdata are dropped (sent as nil)
+    void setValue(const sol::object& value) {
+        if (value.get_type() == sol::type::number) {
+            valueType = ValueType::NUMBER;
+            number = value.as<double>();
+        } else if (value.get_type() == sol::type::boolean) {
+            valueType = ValueType::BOOLEAN;
+            number = value.as<bool>() ? 1.0 : 0.0;
+        } else if (value.get_type() == sol::type::string) {
+            valueType = ValueType::TEXT;
+            text = value.as<std::string>();
+        }
+    }
+
+    sol::object getValue(sol::state_view lua) const {
+        switch (valueType) {
+            case ValueType::NUMBER: return sol::make_object(lua, number);
+            case ValueType::BOOLEAN: return sol::make_object(lua, number != 0.0);
+            case ValueType::TEXT: return sol::make_object(lua, text);
+            default: return sol::lua_nil;
+        }
+    }
+};
+
+// Hot reload swaps a module's contents in place, so instance metatables that index it pick up
+// the new functions without being touched
+inline void replaceTableContents(sol::table& target, const sol::table& source) {
+    std::vector<sol::object> staleKeys;
+    target.for_each([&](const sol::object& key, const sol::object&) {
+        if (source.raw_get<sol::object>(key).get_type() == sol::type::lua_nil) staleKeys.push_back(key);
+    });
+    for (const sol::object& key : staleKeys) {
+        target.raw_set(key, sol::lua_nil);
+    }
+    source.for_each([&](const sol::object& key, const sol::object& value) {
+        target.raw_set(key, value);
+    });
+}
+
+// N isolated Lua states, each on its own thread and each owning a partition of the entities that
+// run parallel scripts (modules that set `parallel = true`). Workers only see a snapshot of the
+// world and write through commands, so they never touch the ECS while it is in use elsewhere.
+class ScriptWorkerPool {
+public:
+    explicit ScriptWorkerPool(int workerCount);
+    ~ScriptWorkerPool();
+
+    ScriptWorkerPool(const ScriptWorkerPool&) = delete;
+    ScriptWorkerPool& operator=(const ScriptWorkerPool&) = delete;
+
+    int getWorkerCount() const { return static_cast<int>(workers.size()); }
+    int getEntityCount() const;
+
+    // Main thread only, while the workers are idle
+    bool addEntity(Entity entity, const std::string& scriptPath, const std::string& bytecode);
+    void removeEntity(Entity entity);
+    bool owns(Entity entity) const { return entity < MAX_ENTITIES && owner[entity] >= 0; }
+    std::vector<std::pair<Entity, std::string>> getEntities() const;
+
+    // Hot reload of a module every worker may have loaded; failures keep the old version
+    void reloadModule(const std::string& scriptPath, const std::string& bytecode);
+
+    // Each worker state has its own sandbox with the same limits. Main thread only, while idle.
+    void setSandboxLimits(const ScriptSandbox::Limits& limits);
+    void resumeSuspended();
+
+    // Messages for entities owned by a worker; returns false if no worker owns the target
+    bool postMessage(ScriptMessage&& message);
+
+    // Runs one frame on every worker. beginFrame returns immediately so the main state can run
+    // at the same time; endFrame waits for the workers and hands back their commands and the
+    // messages they posted to entities the pool does not own.
+    void beginFrame(const ScriptSnapshot* snapshot, float deltaTime);
+    void endFrame(std::vector<ScriptCommand>& commands, std::vector<ScriptMessage>& outgoing);
+    bool isRunning() const { return running; }
+
+    struct WorkerMetrics {
+        int entities = 0;
+        float updateTime = 0.0f;
+        int suspended = 0;             // Entities stopped by a sandbox limit
+    };
+    std::vector<WorkerMetrics> getMetrics() const;
+
+private:
+    struct WorkerInstance {
+        Entity entity;
+        std::string scriptPath;
+        sol::table state;
+        sol::protected_function update;
+        sol::protected_function onMessage;
+        bool errorReported = false;
+        bool suspended = false;
+    };
+
+    struct WorkerModule {
+        sol::table table;
+        sol::table instanceMetatable;
+    };
+
+    struct Worker {
+        int index = 0;
+        ScriptSandbox sandbox;                     // Before the state: it is the state's allocator
+        sol::state lua;
+        std::unordered_map<std::string, WorkerModule> modules;
+        std::vector<WorkerInstance> instances;
+        std::vector<int> slots;                    // Per entity: index into instances, -1 if none
+        std::vector<ScriptMessage> inbox;          // Delivered at the start of the next frame
+        std::vector<ScriptMessage> outbox;
+        std::vector<ScriptCommand> commands;
+        WorkerMetrics metrics;
+        std::thread thread;
+    };
+
+    void registerWorkerAPI(Worker& worker);
+    void runWorker(Worker& worker);
+    void workerLoop(Worker& worker);
+    void reportError(Worker& worker, Entity entity, const std::string& scriptPath, const char* callback, sol::protected_function_result& result);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<int> owner;                        // Per entity: owning worker, -1 if none
+    std::vector<int> entityCounts;
+
+    const ScriptSnapshot* snapshot = nullptr;
+    float frameDeltaTime = 0.0f;
+    bool running = false;
+
+    std::mutex mutex;
+    std::condition_variable startCondition;
+    std::condition_variable doneCondition;
+    std::uint64_t frameGeneration = 0;
+    int workersBusy = 0;
+    bool stopping = false;
+};
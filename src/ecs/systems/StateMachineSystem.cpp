@@ -146,10 +146,13 @@ bool StateMachineSystem::checkEventCondition(const StateTransition& transition,
     
     auto& eventComp = componentManager->getComponent<EventComponent>(entity);
     
+    EventNameId transitionEventId = transition.eventNameId;
+    
     // Check recent events in history
-    for (const auto& event : eventComp.eventHistory) {
+    for (size_t i = 0; i < eventComp.eventHistory.size(); ++i) {
+        const EventData& event = eventComp.eventHistory[i];
         if (event.type == transition.eventType || 
-            (event.type == EventType::CUSTOM_EVENT && event.eventName == transition.eventName)) {
+            (event.type == EventType::CUSTOM_EVENT && event.nameId == transitionEventId)) {
             
             // Check if event is recent enough (within last few frames)
             float currentTime = std::chrono::duration<float>(
@@ -310,7 +313,7 @@ void StateMachineSystem::sendStateEvent(Entity entity, const std::string& stateN
     
     EventData event(eventType, entity, NO_ENTITY, stateName);
     event.setParameter("stateName", stateName);
-    event.setParameter("entity", static_cast<int>(entity));
+    event.setParameterEntity("entity", entity);
     
     eventSystem->broadcastEvent(event);
 }
@@ -0,0 +1,289 @@
+#include "TilemapSystem.h"
+#include "../../AssetManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+void TilemapSystem::update(ComponentManager* componentManager) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    staticColliders.clear();
+
+    for (auto const& entity : entities) {
+        if (!componentManager->hasComponent<TilemapComponent>(entity) ||
+            !componentManager->hasComponent<TransformComponent>(entity)) {
+            continue;
+        }
+
+        auto& tilemap = componentManager->getComponent<TilemapComponent>(entity);
+        auto& transform = componentManager->getComponent<TransformComponent>(entity);
+
+        if (!tilemap.generateCollision) continue;
+        if (tilemap.collisionDirty) {
+            rebuildCollision(tilemap);
+        }
+
+        for (const auto& rect : tilemap.collisionRects) {
+            staticColliders.push_back({entity, {transform.x + rect.x, transform.y + rect.y, rect.w, rect.h}});
+        }
+    }
+
+    metrics.collisionRects = static_cast<int>(staticColliders.size());
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    metrics.updateTime = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+}
+
+// Greedy merge: take the longest horizontal run of solid tiles, then grow it downward
+// while every tile of the next row is solid and unclaimed.
+void TilemapSystem::rebuildCollision(TilemapComponent& tilemap) {
+    tilemap.collisionRects.clear();
+    tilemap.collisionDirty = false;
+
+    const int width = tilemap.width;
+    const int height = tilemap.height;
+    if (width <= 0 || height <= 0) return;
+
+    std::vector<char> claimed(static_cast<size_t>(width) * height, 0);
+    auto isOpen = [&](int tx, int ty) {
+        return !claimed[static_cast<size_t>(ty) * width + tx] && tilemap.isSolid(tilemap.getTile(tx, ty));
+    };
+
+    for (int ty = 0; ty < height; ++ty) {
+        for (int tx = 0; tx < width; ++tx) {
+            if (!isOpen(tx, ty)) continue;
+
+            int runWidth = 1;
+            while (tx + runWidth < width && isOpen(tx + runWidth, ty)) {
+                runWidth++;
+            }
+
+            int runHeight = 1;
+            while (ty + runHeight < height) {
+                bool rowSolid = true;
+                for (int x = tx; x < tx + runWidth; ++x) {
+                    if (!isOpen(x, ty + runHeight)) {
+                        rowSolid = false;
+                        break;
+                    }
+                }
+                if (!rowSolid) break;
+                runHeight++;
+            }
+
+            for (int y = ty; y < ty + runHeight; ++y) {
+                std::fill_n(claimed.begin() + static_cast<size_t>(y) * width + tx, runWidth, 1);
+            }
+
+            tilemap.collisionRects.push_back({
+                static_cast<float>(tx * tilemap.tileWidth),
+                static_cast<float>(ty * tilemap.tileHeight),
+                static_cast<float>(runWidth * tilemap.tileWidth),
+                static_cast<float>(runHeight * tilemap.tileHeight)
+            });
+        }
+    }
+}
+
+void TilemapSystem::render(SDL_Renderer* renderer, ComponentManager* componentManager, float cameraX, float cameraY, float zoom,
+                           const std::unordered_map<std::string, SDL_Texture*>* textureOverrides) {
+    if (!renderer || zoom <= 0.0f) return;
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    metrics.visibleChunks = 0;
+    metrics.chunksBakedThisFrame = 0;
+    pruneCache(componentManager);
+
+    SDL_Rect viewport;
+    SDL_RenderGetViewport(renderer, &viewport);
+    const float viewLeft = cameraX;
+    const float viewTop = cameraY;
+    const float viewRight = cameraX + viewport.w / zoom;
+    const float viewBottom = cameraY + viewport.h / zoom;
+    const bool useChunkTextures = SDL_RenderTargetSupported(renderer) == SDL_TRUE;
+
+    std::vector<Entity> tilemapEntities(entities.begin(), entities.end());
+    std::sort(tilemapEntities.begin(), tilemapEntities.end(), [&](Entity a, Entity b) {
+        return componentManager->getComponent<TransformComponent>(a).z_index <
+               componentManager->getComponent<TransformComponent>(b).z_index;
+    });
+
+    for (auto entity : tilemapEntities) {
+        auto& tilemap = componentManager->getComponent<TilemapComponent>(entity);
+        auto& transform = componentManager->getComponent<TransformComponent>(entity);
+        if (tilemap.chunks.empty() || tilemap.tileWidth <= 0 || tilemap.tileHeight <= 0) continue;
+
+        // Overrides belong to another renderer; AssetManager textures cannot be drawn with it
+        SDL_Texture* tileset = nullptr;
+        if (textureOverrides) {
+            auto it = textureOverrides->find(tilemap.tilesetTextureId);
+            if (it != textureOverrides->end()) tileset = it->second;
+        } else {
+            tileset = AssetManager::getInstance().getTexture(tilemap.tilesetTextureId);
+        }
+        if (!tileset) continue;
+
+        const float chunkPixelW = static_cast<float>(TILEMAP_CHUNK_SIZE * tilemap.tileWidth);
+        const float chunkPixelH = static_cast<float>(TILEMAP_CHUNK_SIZE * tilemap.tileHeight);
+
+        // Visible chunk range in tilemap-local space
+        int firstChunkX = std::max(0, static_cast<int>(std::floor((viewLeft - transform.x) / chunkPixelW)));
+        int firstChunkY = std::max(0, static_cast<int>(std::floor((viewTop - transform.y) / chunkPixelH)));
+        int lastChunkX = std::min(tilemap.chunksX - 1, static_cast<int>(std::floor((viewRight - transform.x) / chunkPixelW)));
+        int lastChunkY = std::min(tilemap.chunksY - 1, static_cast<int>(std::floor((viewBottom - transform.y) / chunkPixelH)));
+        if (firstChunkX > lastChunkX || firstChunkY > lastChunkY) continue;
+
+        auto& cacheEntries = chunkCache[{renderer, entity}];
+        if (cacheEntries.size() != tilemap.chunks.size()) {
+            for (auto& entry : cacheEntries) {
+                if (entry.texture) SDL_DestroyTexture(entry.texture);
+            }
+            cacheEntries.assign(tilemap.chunks.size(), ChunkCacheEntry{});
+        }
+
+        for (int cy = firstChunkY; cy <= lastChunkY; ++cy) {
+            for (int cx = firstChunkX; cx <= lastChunkX; ++cx) {
+                const TilemapChunk& chunk = tilemap.chunks[cy * tilemap.chunksX + cx];
+                if (chunk.filledTiles == 0) continue;
+                metrics.visibleChunks++;
+
+                float originX = transform.x + cx * chunkPixelW;
+                float originY = transform.y + cy * chunkPixelH;
+
+                ChunkCacheEntry& entry = cacheEntries[cy * tilemap.chunksX + cx];
+                if (useChunkTextures) {
+                    if (!entry.texture || entry.revision != chunk.revision ||
+                        entry.layoutRevision != tilemap.layoutRevision || entry.tileset != tileset) {
+                        if (!bakeChunk(renderer, tilemap, cx, cy, tileset, entry)) {
+                            drawChunkDirect(renderer, tilemap, cx, cy, tileset, originX - cameraX, originY - cameraY, zoom);
+                            continue;
+                        }
+                        entry.revision = chunk.revision;
+                        entry.layoutRevision = tilemap.layoutRevision;
+                        entry.tileset = tileset;
+                        metrics.chunksBakedThisFrame++;
+                    }
+
+                    int textureW = 0, textureH = 0;
+                    SDL_QueryTexture(entry.texture, nullptr, nullptr, &textureW, &textureH);
+
+                    // Snap both edges so neighbouring chunks never leave a seam at fractional zoom
+                    int left = static_cast<int>(std::floor((originX - cameraX) * zoom));
+                    int top = static_cast<int>(std::floor((originY - cameraY) * zoom));
+                    int right = static_cast<int>(std::floor((originX + textureW - cameraX) * zoom));
+                    int bottom = static_cast<int>(std::floor((originY + textureH - cameraY) * zoom));
+                    SDL_Rect destRect = {left, top, right - left, bottom - top};
+                    SDL_RenderCopy(renderer, entry.texture, nullptr, &destRect);
+                } else {
+                    drawChunkDirect(renderer, tilemap, cx, cy, tileset, originX - cameraX, originY - cameraY, zoom);
+                }
+            }
+        }
+    }
+
+    metrics.cachedChunkTextures = 0;
+    for (const auto& cacheEntry : chunkCache) {
+        for (const auto& entry : cacheEntry.second) {
+            if (entry.texture) metrics.cachedChunkTextures++;
+        }
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    metrics.renderTime = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+}
+
+bool TilemapSystem::bakeChunk(SDL_Renderer* renderer, const TilemapComponent& tilemap, int chunkX, int chunkY,
+                              SDL_Texture* tileset, ChunkCacheEntry& entry) {
+    // Edge chunks only cover the tiles that exist
+    int tilesX = std::min(TILEMAP_CHUNK_SIZE, tilemap.width - chunkX * TILEMAP_CHUNK_SIZE);
+    int tilesY = std::min(TILEMAP_CHUNK_SIZE, tilemap.height - chunkY * TILEMAP_CHUNK_SIZE);
+    int textureW = tilesX * tilemap.tileWidth;
+    int textureH = tilesY * tilemap.tileHeight;
+
+    if (entry.texture) {
+        int currentW = 0, currentH = 0;
+        SDL_QueryTexture(entry.texture, nullptr, nullptr, &currentW, &currentH);
+        if (currentW != textureW || currentH != textureH) {
+            SDL_DestroyTexture(entry.texture);
+            entry.texture = nullptr;
+        }
+    }
+    if (!entry.texture) {
+        entry.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, textureW, textureH);
+        if (!entry.texture) {
+            std::cerr << "[TilemapSystem] Failed to create chunk texture: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        SDL_SetTextureBlendMode(entry.texture, SDL_BLENDMODE_BLEND);
+    }
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+
+    if (SDL_SetRenderTarget(renderer, entry.texture) != 0) {
+        std::cerr << "[TilemapSystem] Failed to bind chunk texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    drawChunkDirect(renderer, tilemap, chunkX, chunkY, tileset, 0.0f, 0.0f, 1.0f);
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    return true;
+}
+
+void TilemapSystem::drawChunkDirect(SDL_Renderer* renderer, const TilemapComponent& tilemap, int chunkX, int chunkY,
+                                    SDL_Texture* tileset, float originX, float originY, float zoom) {
+    const int baseX = chunkX * TILEMAP_CHUNK_SIZE;
+    const int baseY = chunkY * TILEMAP_CHUNK_SIZE;
+    const int endX = std::min(baseX + TILEMAP_CHUNK_SIZE, tilemap.width);
+    const int endY = std::min(baseY + TILEMAP_CHUNK_SIZE, tilemap.height);
+
+    for (int ty = baseY; ty < endY; ++ty) {
+        for (int tx = baseX; tx < endX; ++tx) {
+            int id = tilemap.getTile(tx, ty);
+            if (id == TILE_EMPTY) continue;
+
+            SDL_Rect srcRect = {0, 0, tilemap.tileWidth, tilemap.tileHeight};
+            tilemap.getTileSourceRect(id, srcRect.x, srcRect.y);
+
+            float localX = static_cast<float>((tx - baseX) * tilemap.tileWidth);
+            float localY = static_cast<float>((ty - baseY) * tilemap.tileHeight);
+            int left = static_cast<int>(std::floor(originX * zoom + localX * zoom));
+            int top = static_cast<int>(std::floor(originY * zoom + localY * zoom));
+            int right = static_cast<int>(std::floor(originX * zoom + (localX + tilemap.tileWidth) * zoom));
+            int bottom = static_cast<int>(std::floor(originY * zoom + (localY + tilemap.tileHeight) * zoom));
+            SDL_Rect destRect = {left, top, right - left, bottom - top};
+            SDL_RenderCopy(renderer, tileset, &srcRect, &destRect);
+        }
+    }
+}
+
+void TilemapSystem::pruneCache(ComponentManager* componentManager) {
+    for (auto it = chunkCache.begin(); it != chunkCache.end();) {
+        Entity entity = it->first.second;
+        if (entities.find(entity) == entities.end() || !componentManager->hasComponent<TilemapComponent>(entity)) {
+            for (auto& entry : it->second) {
+                if (entry.texture) SDL_DestroyTexture(entry.texture);
+            }
+            it = chunkCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TilemapSystem::releaseRenderer(SDL_Renderer* renderer) {
+    for (auto it = chunkCache.begin(); it != chunkCache.end();) {
+        if (it->first.first == renderer) {
+            for (auto& entry : it->second) {
+                if (entry.texture) SDL_DestroyTexture(entry.texture);
+            }
+            it = chunkCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
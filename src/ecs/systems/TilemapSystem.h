@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../System.h"
+#include "../ComponentManager.h"
+#include "../components/TransformComponent.h"
+#include "../components/TilemapComponent.h"
+#include "CollisionSystem.h"
+#include <SDL2/SDL.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <iostream>
+
+class TilemapSystem : public System {
+public:
+    // Cached textures belong to their renderer and are freed by SDL_DestroyRenderer,
+    // which may run before this system is destroyed
+    TilemapSystem() = default;
+    ~TilemapSystem() = default;
+
+    // Rebuilds merged collision rects for edited tilemaps and refreshes the world-space collider list
+    void update(ComponentManager* componentManager);
+
+    // Draws visible chunks. Chunk textures are cached per renderer and only re-baked when a chunk is edited.
+    // textureOverrides lets a secondary renderer (e.g. the game window) supply its own tileset textures.
+    void render(SDL_Renderer* renderer, ComponentManager* componentManager, float cameraX, float cameraY, float zoom = 1.0f,
+                const std::unordered_map<std::string, SDL_Texture*>* textureOverrides = nullptr);
+
+    const std::vector<StaticCollider>& getStaticColliders() const { return staticColliders; }
+
+    // Drops all cached textures created with this renderer (call before destroying it)
+    void releaseRenderer(SDL_Renderer* renderer);
+
+    struct PerformanceMetrics {
+        int visibleChunks = 0;
+        int chunksBakedThisFrame = 0;
+        int cachedChunkTextures = 0;
+        int collisionRects = 0;
+        float updateTime = 0.0f;
+        float renderTime = 0.0f;
+    };
+
+    const PerformanceMetrics& getMetrics() const { return metrics; }
+
+private:
+    struct ChunkCacheEntry {
+        SDL_Texture* texture = nullptr;
+        std::uint32_t revision = 0;
+        std::uint32_t layoutRevision = 0;
+        SDL_Texture* tileset = nullptr;
+    };
+
+    // Keyed by (renderer, entity); each entry holds one slot per chunk
+    std::map<std::pair<SDL_Renderer*, Entity>, std::vector<ChunkCacheEntry>> chunkCache;
+    std::vector<StaticCollider> staticColliders;
+    PerformanceMetrics metrics;
+
+    void rebuildCollision(TilemapComponent& tilemap);
+    bool bakeChunk(SDL_Renderer* renderer, const TilemapComponent& tilemap, int chunkX, int chunkY,
+                   SDL_Texture* tileset, ChunkCacheEntry& entry);
+    void drawChunkDirect(SDL_Renderer* renderer, const TilemapComponent& tilemap, int chunkX, int chunkY,
+                         SDL_Texture* tileset, float originX, float originY, float zoom);
+    void pruneCache(ComponentManager* componentManager);
+};
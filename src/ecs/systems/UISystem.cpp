@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <functional>
 
 UISystem::UISystem() : assetManager(AssetManager::getInstance()) {
     std::cout << "[UISystem] Initialized" << std::endl;
@@ -291,15 +292,27 @@ void UISystem::sortUIElementsByZOrder(ComponentManager* componentManager) {
 void UISystem::render(SDL_Renderer* renderer, ComponentManager* componentManager) {
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    // Render UI elements in z-order (back to front)
+    updateLayerCache(renderer, componentManager);
+
+    // Render UI elements in z-order (back to front). Members of a cached layer are drawn
+    // once, as the layer texture, at the z-order of the layer root.
     for (Entity entity : sortedUIElements) {
         if (!componentManager->hasComponent<UIComponent>(entity)) continue;
 
+        Entity owner = layerOwner[entity];
+        if (owner == entity) {
+            flushText(renderer);
+            compositeLayer(renderer, entity, layerCache[{renderer, entity}], componentManager);
+            continue;
+        }
+        if (owner != NO_ENTITY) continue;
+
         auto& ui = componentManager->getComponent<UIComponent>(entity);
         if (ui.visible) {
             renderUIElement(entity, componentManager, renderer);
         }
     }
+    flushText(renderer);
 
     auto endTime = std::chrono::high_resolution_clock::now();
     metrics.renderTime = std::chrono::duration<float, std::milli>(endTime - startTime).count();
@@ -353,8 +366,11 @@ void UISystem::renderUIElement(Entity entity, ComponentManager* componentManager
 
     // Debug mode: draw bounding boxes
     if (debugMode) {
+        flushText(renderer);
         SDL_SetRenderDrawColor(renderer, 255, 0, 0, 128);
         SDL_Rect debugRect = ui.getRect();
+        debugRect.x -= renderOffset.x;
+        debugRect.y -= renderOffset.y;
         SDL_RenderDrawRect(renderer, &debugRect);
     }
 }
@@ -438,11 +454,19 @@ void UISystem::renderInputField(Entity entity, const UIComponent& ui, const UIIn
 
     // Draw cursor if focused
     if (input.focused && input.showCursor && !input.text.empty()) {
-        // Calculate cursor position (simplified)
-        int cursorX = rect.x + ui.style.paddingLeft + (input.cursorPosition * 8); // Approximate
+        // Text is centered on its anchor, so offset the prefix width by half the text width
+        int cursorX = rect.x + ui.style.paddingLeft + (input.cursorPosition * 8); // Approximate if the font is missing
+        GlyphAtlas* atlas = getGlyphAtlas(renderer, ui.style.fontFamily);
+        if (atlas) {
+            int textWidth, textHeight;
+            atlas->measure(input.text, textWidth, textHeight);
+            cursorX = rect.x + ui.style.paddingLeft - textWidth / 2 + atlas->measurePrefix(input.text, input.cursorPosition);
+        }
+        flushText(renderer);
         SDL_SetRenderDrawColor(renderer, ui.style.textColor.r, ui.style.textColor.g,
                               ui.style.textColor.b, ui.style.textColor.a);
-        SDL_RenderDrawLine(renderer, cursorX, rect.y + 2, cursorX, rect.y + rect.h - 2);
+        cursorX -= renderOffset.x;
+        SDL_RenderDrawLine(renderer, cursorX, rect.y - renderOffset.y + 2, cursorX, rect.y - renderOffset.y + rect.h - 2);
     }
 }
 
@@ -475,16 +499,21 @@ void UISystem::renderImage(Entity entity, const UIComponent& ui, const UIImageCo
         }
     }
 
+    destRect.x -= renderOffset.x;
+    destRect.y -= renderOffset.y;
+    flushText(renderer);
     SDL_RenderCopy(renderer, texture, nullptr, &destRect);
 }
 
 void UISystem::drawRectangle(SDL_Renderer* renderer, const SDL_Rect& rect, const SDL_Color& color, bool filled) {
+    flushText(renderer);
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
 
+    SDL_Rect target = {rect.x - renderOffset.x, rect.y - renderOffset.y, rect.w, rect.h};
     if (filled) {
-        SDL_RenderFillRect(renderer, &rect);
+        SDL_RenderFillRect(renderer, &target);
     } else {
-        SDL_RenderDrawRect(renderer, &rect);
+        SDL_RenderDrawRect(renderer, &target);
     }
 }
 
@@ -494,46 +523,97 @@ void UISystem::drawRoundedRectangle(SDL_Renderer* renderer, const SDL_Rect& rect
 }
 
 void UISystem::drawText(SDL_Renderer* renderer, const std::string& text, int x, int y, const SDL_Color& color, const std::string& fontId) {
-    SDL_Texture* textTexture = getTextTexture(text, color, fontId);
-    if (!textTexture) return;
+    GlyphAtlas* atlas = getGlyphAtlas(renderer, fontId);
+    if (!atlas || !atlas->getTexture() || text.empty()) return;
 
     int textWidth, textHeight;
-    SDL_QueryTexture(textTexture, nullptr, nullptr, &textWidth, &textHeight);
+    atlas->measure(text, textWidth, textHeight);
+    float left = static_cast<float>(x - textWidth / 2 - renderOffset.x);
+    float top = static_cast<float>(y - textHeight / 2 - renderOffset.y);
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (textBatchTexture != atlas->getTexture()) {
+        flushText(renderer);
+        textBatchTexture = atlas->getTexture();
+    }
 
-    SDL_Rect destRect = {x - textWidth / 2, y - textHeight / 2, textWidth, textHeight};
-    SDL_RenderCopy(renderer, textTexture, nullptr, &destRect);
+    const float invW = 1.0f / atlas->getTextureWidth();
+    const float invH = 1.0f / atlas->getTextureHeight();
+    atlas->layout(text, left, top, [&](const GlyphAtlas::Glyph& glyph, float gx, float gy) {
+        int base = static_cast<int>(textVertices.size());
+        float u0 = glyph.src.x * invW;
+        float v0 = glyph.src.y * invH;
+        float u1 = (glyph.src.x + glyph.src.w) * invW;
+        float v1 = (glyph.src.y + glyph.src.h) * invH;
+        float x1 = gx + glyph.src.w;
+        float y1 = gy + glyph.src.h;
+        textVertices.push_back({{gx, gy}, color, {u0, v0}});
+        textVertices.push_back({{x1, gy}, color, {u1, v0}});
+        textVertices.push_back({{x1, y1}, color, {u1, v1}});
+        textVertices.push_back({{gx, y1}, color, {u0, v1}});
+        textIndices.insert(textIndices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+    });
+#else
+    // No geometry API: copy glyph by glyph with the color applied as a texture modulation
+    SDL_Texture* atlasTexture = atlas->getTexture();
+    SDL_SetTextureColorMod(atlasTexture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(atlasTexture, color.a);
+    atlas->layout(text, left, top, [&](const GlyphAtlas::Glyph& glyph, float gx, float gy) {
+        SDL_Rect destRect = {static_cast<int>(gx), static_cast<int>(gy), glyph.src.w, glyph.src.h};
+        SDL_RenderCopy(renderer, atlasTexture, &glyph.src, &destRect);
+    });
+#endif
 }
 
-SDL_Texture* UISystem::getTextTexture(const std::string& text, const SDL_Color& color, const std::string& fontId) {
-    std::string cacheKey = getTextCacheKey(text, color, fontId);
+void UISystem::flushText(SDL_Renderer* renderer) {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (!textIndices.empty() && textBatchTexture) {
+        SDL_RenderGeometry(renderer, textBatchTexture, textVertices.data(), static_cast<int>(textVertices.size()),
+                           textIndices.data(), static_cast<int>(textIndices.size()));
+    }
+#endif
+    textVertices.clear();
+    textIndices.clear();
+    textBatchTexture = nullptr;
+}
 
-    auto it = textCache.find(cacheKey);
-    if (it != textCache.end()) {
-        return it->second;
+GlyphAtlas* UISystem::getGlyphAtlas(SDL_Renderer* renderer, const std::string& fontId) {
+    auto key = std::make_pair(renderer, fontId);
+    auto it = glyphAtlases.find(key);
+    if (it != glyphAtlases.end()) {
+        return it->second.get();
     }
 
-    // Create new text texture
+    // Built once per font; failures are remembered so a missing font is not looked up every frame
+    std::unique_ptr<GlyphAtlas> atlas;
     TTF_Font* font = assetManager.getFont(fontId);
-    if (!font) return nullptr;
-
-    SDL_Surface* textSurface = TTF_RenderText_Blended(font, text.c_str(), color);
-    if (!textSurface) return nullptr;
-
-    // We need to get the renderer from somewhere - for now, return nullptr
-    // In a real implementation, we'd pass the renderer to the UISystem
-    SDL_Texture* textTexture = nullptr; // SDL_CreateTextureFromSurface(renderer, textSurface);
-    SDL_FreeSurface(textSurface);
-
-    if (textTexture) {
-        textCache[cacheKey] = textTexture;
+    if (font) {
+        atlas = std::make_unique<GlyphAtlas>();
+        if (!atlas->build(renderer, font)) {
+            std::cerr << "[UISystem] Failed to build glyph atlas for font '" << fontId << "'" << std::endl;
+            atlas.reset();
+        }
     }
+    GlyphAtlas* result = atlas.get();
+    glyphAtlases[key] = std::move(atlas);
+    return result;
+}
 
-    return textTexture;
+bool UISystem::measureText(SDL_Renderer* renderer, const std::string& text, const std::string& fontId, int& width, int& height) {
+    GlyphAtlas* atlas = getGlyphAtlas(renderer, fontId);
+    if (!atlas) return false;
+    atlas->measure(text, width, height);
+    return true;
 }
 
-std::string UISystem::getTextCacheKey(const std::string& text, const SDL_Color& color, const std::string& fontId) {
-    return text + "_" + std::to_string(color.r) + "_" + std::to_string(color.g) + "_" +
-           std::to_string(color.b) + "_" + std::to_string(color.a) + "_" + fontId;
+void UISystem::clearTextCache() {
+    for (auto& entry : glyphAtlases) {
+        if (entry.second) entry.second->releaseTexture();
+    }
+    glyphAtlases.clear();
+    textVertices.clear();
+    textIndices.clear();
+    textBatchTexture = nullptr;
 }
 
 // UI Element Creation Methods
@@ -860,6 +940,349 @@ void UISystem::triggerCallback(Entity entity, UIEventCallback callback) {
     }
 }
 
+// Retained layer rendering
+bool UISystem::isLayerCandidate(const UIComponent& ui) const {
+    if (ui.cacheAsTexture) return true;
+    return rootCachingEnabled && ui.parent == NO_ENTITY && !ui.children.empty();
+}
+
+void UISystem::collectSubtree(Entity entity, ComponentManager* componentManager, std::vector<Entity>& out) {
+    out.push_back(entity);
+    auto& ui = componentManager->getComponent<UIComponent>(entity);
+    for (Entity child : ui.children) {
+        if (componentManager->hasComponent<UIComponent>(child)) {
+            collectSubtree(child, componentManager, out);
+        }
+    }
+}
+
+// Hash of everything that affects how an element looks. Positions are taken relative to the
+// layer root so moving a whole panel only moves the cached texture instead of re-baking it.
+size_t UISystem::computeVisualHash(Entity entity, const UIComponent& root, ComponentManager* componentManager) {
+    auto& ui = componentManager->getComponent<UIComponent>(entity);
+    size_t hash = 0;
+    auto combine = [&hash](size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    };
+    auto packColor = [](const SDL_Color& c) {
+        return static_cast<size_t>(c.r) | (static_cast<size_t>(c.g) << 8) |
+               (static_cast<size_t>(c.b) << 16) | (static_cast<size_t>(c.a) << 24);
+    };
+    std::hash<float> hashFloat;
+    std::hash<std::string> hashString;
+
+    combine(entity);
+    combine(static_cast<size_t>(ui.type));
+    combine(static_cast<size_t>(ui.state));
+    combine(ui.visible);
+    combine(ui.zOrder);
+    combine(hashFloat(ui.absoluteX - root.absoluteX));
+    combine(hashFloat(ui.absoluteY - root.absoluteY));
+    combine(hashFloat(ui.width));
+    combine(hashFloat(ui.height));
+    combine(packColor(ui.getCurrentBackgroundColor()));
+    combine(packColor(ui.style.borderColor));
+    combine(packColor(ui.style.textColor));
+    combine(ui.style.borderWidth);
+    combine(ui.style.cornerRadius);
+    combine(ui.style.paddingLeft);
+    combine(ui.style.paddingTop);
+    combine(hashString(ui.style.fontFamily));
+    combine(debugMode);
+
+    switch (ui.type) {
+        case UIElementType::BUTTON:
+            if (componentManager->hasComponent<UIButtonComponent>(entity)) {
+                combine(hashString(componentManager->getComponent<UIButtonComponent>(entity).text));
+            }
+            break;
+        case UIElementType::TEXT:
+            if (componentManager->hasComponent<UITextComponent>(entity)) {
+                combine(hashString(componentManager->getComponent<UITextComponent>(entity).text));
+            }
+            break;
+        case UIElementType::SLIDER:
+            if (componentManager->hasComponent<UISliderComponent>(entity)) {
+                combine(hashFloat(componentManager->getComponent<UISliderComponent>(entity).getNormalizedValue()));
+            }
+            break;
+        case UIElementType::INPUT_FIELD:
+            if (componentManager->hasComponent<UIInputFieldComponent>(entity)) {
+                auto& input = componentManager->getComponent<UIInputFieldComponent>(entity);
+                combine(hashString(input.text));
+                combine(hashString(input.placeholder));
+                combine(input.focused && input.showCursor);
+                combine(input.cursorPosition);
+            }
+            break;
+        case UIElementType::IMAGE:
+            if (componentManager->hasComponent<UIImageComponent>(entity)) {
+                auto& image = componentManager->getComponent<UIImageComponent>(entity);
+                combine(hashString(image.textureId));
+                combine(reinterpret_cast<size_t>(assetManager.getTexture(image.textureId)));
+                combine(image.preserveAspectRatio);
+            }
+            break;
+        default:
+            break;
+    }
+    return hash;
+}
+
+SDL_Rect UISystem::computeElementBounds(SDL_Renderer* renderer, Entity entity, const UIComponent& ui, ComponentManager* componentManager) {
+    SDL_Rect bounds = ui.getRect();
+
+    // Text is centered on an anchor point and may spill outside the element rect
+    std::string text;
+    int anchorX = bounds.x;
+    int anchorY = bounds.y;
+    if (ui.type == UIElementType::BUTTON && componentManager->hasComponent<UIButtonComponent>(entity)) {
+        text = componentManager->getComponent<UIButtonComponent>(entity).text;
+        anchorX = bounds.x + bounds.w / 2;
+        anchorY = bounds.y + bounds.h / 2;
+    } else if (ui.type == UIElementType::TEXT && componentManager->hasComponent<UITextComponent>(entity)) {
+        text = componentManager->getComponent<UITextComponent>(entity).text;
+        anchorX = static_cast<int>(ui.absoluteX + ui.style.paddingLeft);
+        anchorY = static_cast<int>(ui.absoluteY + ui.style.paddingTop);
+    } else if (ui.type == UIElementType::INPUT_FIELD && componentManager->hasComponent<UIInputFieldComponent>(entity)) {
+        auto& input = componentManager->getComponent<UIInputFieldComponent>(entity);
+        text = input.text.empty() ? input.placeholder : input.text;
+        anchorX = bounds.x + ui.style.paddingLeft;
+        anchorY = bounds.y + ui.style.paddingTop;
+    } else if (ui.type == UIElementType::SLIDER) {
+        // Handle is 20px tall regardless of the track height
+        int handleTop = bounds.y + bounds.h / 2 - 10;
+        int handleBottom = handleTop + 20;
+        int top = std::min(bounds.y, handleTop);
+        bounds.h = std::max(bounds.y + bounds.h, handleBottom) - top;
+        bounds.y = top;
+    }
+
+    if (!text.empty()) {
+        int textWidth = 0, textHeight = 0;
+        if (measureText(renderer, text, ui.style.fontFamily, textWidth, textHeight)) {
+            SDL_Rect textRect = {anchorX - textWidth / 2, anchorY - textHeight / 2, textWidth, textHeight};
+            SDL_UnionRect(&bounds, &textRect, &bounds);
+        }
+    }
+    return bounds;
+}
+
+void UISystem::updateLayerCache(SDL_Renderer* renderer, ComponentManager* componentManager) {
+    metrics.cachedLayers = 0;
+    metrics.layerRebakes = 0;
+
+    if (layerOwner.size() != MAX_ENTITIES + 1) {
+        layerOwner.assign(MAX_ENTITIES + 1, NO_ENTITY);
+    }
+    for (Entity entity : sortedUIElements) {
+        layerOwner[entity] = NO_ENTITY;
+    }
+    for (auto& cached : layerCache) {
+        if (cached.first.first == renderer) cached.second.seenThisFrame = false;
+    }
+
+    const bool targetsSupported = SDL_RenderTargetSupported(renderer) == SDL_TRUE;
+
+    // Pass 1: hash every candidate subtree and track how often it changes
+    std::vector<Entity> candidates;
+    if (targetsSupported) {
+        for (Entity entity : sortedUIElements) {
+            if (!componentManager->hasComponent<UIComponent>(entity)) continue;
+            auto& ui = componentManager->getComponent<UIComponent>(entity);
+            if (!isLayerCandidate(ui)) continue;
+
+            LayerCacheEntry& entry = layerCache[{renderer, entity}];
+            entry.seenThisFrame = true;
+            entry.members.clear();
+            collectSubtree(entity, componentManager, entry.members);
+            std::stable_sort(entry.members.begin(), entry.members.end(), [componentManager](Entity a, Entity b) {
+                return componentManager->getComponent<UIComponent>(a).zOrder <
+                       componentManager->getComponent<UIComponent>(b).zOrder;
+            });
+
+            size_t hash = entry.members.size();
+            for (Entity member : entry.members) {
+                hash = hash * 31 + computeVisualHash(member, ui, componentManager);
+            }
+
+            if (hash != entry.visualHash) {
+                entry.visualHash = hash;
+                entry.dirty = true;
+                entry.changedFrames++;
+                entry.stableFrames = 0;
+            } else {
+                entry.changedFrames = 0;
+                entry.stableFrames++;
+            }
+
+            // Only automatic roots fall back to direct drawing; explicitly flagged subtrees stay cached
+            if (!ui.cacheAsTexture) {
+                if (entry.changedFrames >= 3) entry.isVolatile = true;
+                else if (entry.isVolatile && entry.stableFrames >= 30) entry.isVolatile = false;
+            } else {
+                entry.isVolatile = false;
+            }
+            candidates.push_back(entity);
+        }
+    }
+
+    // Pass 2: the outermost active layer owns its subtree
+    for (Entity root : candidates) {
+        LayerCacheEntry& entry = layerCache[{renderer, root}];
+        if (entry.isVolatile) continue;
+
+        bool ownedByAncestor = false;
+        Entity ancestor = componentManager->getComponent<UIComponent>(root).parent;
+        while (ancestor != NO_ENTITY && componentManager->hasComponent<UIComponent>(ancestor)) {
+            auto parentEntry = layerCache.find({renderer, ancestor});
+            if (parentEntry != layerCache.end() && parentEntry->second.seenThisFrame && !parentEntry->second.isVolatile) {
+                ownedByAncestor = true;
+                break;
+            }
+            ancestor = componentManager->getComponent<UIComponent>(ancestor).parent;
+        }
+        if (ownedByAncestor) continue;
+
+        if (entry.dirty || !entry.texture) {
+            if (!bakeLayer(renderer, root, entry, componentManager)) continue;
+            entry.dirty = false;
+            metrics.layerRebakes++;
+        }
+
+        for (Entity member : entry.members) {
+            layerOwner[member] = root;
+        }
+        metrics.cachedLayers++;
+    }
+
+    // Drop layers whose root disappeared or stopped being a candidate
+    for (auto it = layerCache.begin(); it != layerCache.end();) {
+        if (it->first.first == renderer && !it->second.seenThisFrame) {
+            if (it->second.texture) SDL_DestroyTexture(it->second.texture);
+            it = layerCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool UISystem::bakeLayer(SDL_Renderer* renderer, Entity root, LayerCacheEntry& entry, ComponentManager* componentManager) {
+    if (!premultipliedBlendSupported) return false;   // Members are drawn directly instead
+    auto& rootUI = componentManager->getComponent<UIComponent>(root);
+
+    bool hasBounds = false;
+    SDL_Rect bounds = {0, 0, 0, 0};
+    for (Entity member : entry.members) {
+        auto& ui = componentManager->getComponent<UIComponent>(member);
+        if (!ui.visible) continue;
+        SDL_Rect elementBounds = computeElementBounds(renderer, member, ui, componentManager);
+        if (!hasBounds) {
+            bounds = elementBounds;
+            hasBounds = true;
+        } else {
+            SDL_UnionRect(&bounds, &elementBounds, &bounds);
+        }
+    }
+    if (!hasBounds || bounds.w <= 0 || bounds.h <= 0) {
+        // Nothing visible: keep the layer (so members stay hidden) with an empty texture
+        if (entry.texture) {
+            SDL_DestroyTexture(entry.texture);
+            entry.texture = nullptr;
+        }
+        entry.bounds = {0, 0, 0, 0};
+        return true;
+    }
+
+    if (entry.texture) {
+        int textureW = 0, textureH = 0;
+        SDL_QueryTexture(entry.texture, nullptr, nullptr, &textureW, &textureH);
+        if (textureW != bounds.w || textureH != bounds.h) {
+            SDL_DestroyTexture(entry.texture);
+            entry.texture = nullptr;
+        }
+    }
+    if (!entry.texture) {
+        entry.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, bounds.w, bounds.h);
+        if (!entry.texture) {
+            std::cerr << "[UISystem] Failed to create layer texture: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        // Baking blends members into a transparent target, which leaves colors premultiplied by
+        // their alpha. Plain BLEND would apply the alpha a second time when compositing.
+        static const SDL_BlendMode premultipliedBlend = SDL_ComposeCustomBlendMode(
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+        if (SDL_SetTextureBlendMode(entry.texture, premultipliedBlend) != 0) {
+            std::cerr << "[UISystem] Renderer lacks premultiplied blending, layer caching disabled: " << SDL_GetError() << std::endl;
+            premultipliedBlendSupported = false;
+            SDL_DestroyTexture(entry.texture);
+            entry.texture = nullptr;
+            return false;
+        }
+    }
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    if (SDL_SetRenderTarget(renderer, entry.texture) != 0) {
+        std::cerr << "[UISystem] Failed to bind layer texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    renderOffset = {bounds.x, bounds.y};
+    for (Entity member : entry.members) {
+        auto& ui = componentManager->getComponent<UIComponent>(member);
+        if (ui.visible) {
+            renderUIElement(member, componentManager, renderer);
+        }
+    }
+    flushText(renderer);
+    renderOffset = {0, 0};
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+
+    entry.bounds = {bounds.x - static_cast<int>(rootUI.absoluteX), bounds.y - static_cast<int>(rootUI.absoluteY), bounds.w, bounds.h};
+    return true;
+}
+
+void UISystem::compositeLayer(SDL_Renderer* renderer, Entity root, const LayerCacheEntry& entry, ComponentManager* componentManager) {
+    if (!entry.texture) return;
+    auto& rootUI = componentManager->getComponent<UIComponent>(root);
+    SDL_Rect destRect = {
+        static_cast<int>(rootUI.absoluteX) + entry.bounds.x,
+        static_cast<int>(rootUI.absoluteY) + entry.bounds.y,
+        entry.bounds.w,
+        entry.bounds.h
+    };
+    SDL_RenderCopy(renderer, entry.texture, nullptr, &destRect);
+}
+
+void UISystem::invalidateRenderCache(Entity root) {
+    for (auto& cached : layerCache) {
+        if (cached.first.second == root) cached.second.dirty = true;
+    }
+}
+
+void UISystem::releaseRenderer(SDL_Renderer* renderer) {
+    for (auto it = glyphAtlases.begin(); it != glyphAtlases.end();) {
+        if (it->first.first == renderer) {
+            if (it->second) it->second->releaseTexture();
+            it = glyphAtlases.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = layerCache.begin(); it != layerCache.end();) {
+        if (it->first.first == renderer) {
+            if (it->second.texture) SDL_DestroyTexture(it->second.texture);
+            it = layerCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 void UISystem::resetMetrics() {
     metrics = PerformanceMetrics{};
 }
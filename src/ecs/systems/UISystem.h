@@ -8,9 +8,12 @@
 #include "../EntityManager.h"
 #include "../../AssetManager.h"
 #include "../../InputManager.h"
+#include "../../text/GlyphAtlas.h"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <queue>
+#include <map>
+#include <memory>
 #include <unordered_map>
 #include <iostream>
 
@@ -49,6 +52,12 @@ public:
     void setTheme(const std::string& themeName);
     void applyTheme(Entity entity, ComponentManager* componentManager);
     
+    // Retained rendering: UI roots and subtrees flagged cacheAsTexture are baked into target
+    // textures and recomposited each frame until their visual state changes
+    void setRootCaching(bool enable) { rootCachingEnabled = enable; }
+    void invalidateRenderCache(Entity root);
+    void releaseRenderer(SDL_Renderer* renderer);
+    
     // Performance metrics
     struct PerformanceMetrics {
         int totalUIElements = 0;
@@ -58,6 +67,8 @@ public:
         float renderTime = 0.0f;
         int layoutUpdates = 0;
         int eventHandles = 0;
+        int cachedLayers = 0;
+        int layerRebakes = 0;
     };
     
     const PerformanceMetrics& getMetrics() const { return metrics; }
@@ -101,7 +112,9 @@ private:
     void drawRectangle(SDL_Renderer* renderer, const SDL_Rect& rect, const SDL_Color& color, bool filled = true);
     void drawRoundedRectangle(SDL_Renderer* renderer, const SDL_Rect& rect, int radius, const SDL_Color& color);
     void drawText(SDL_Renderer* renderer, const std::string& text, int x, int y, const SDL_Color& color, const std::string& fontId);
-    SDL_Texture* getTextTexture(const std::string& text, const SDL_Color& color, const std::string& fontId);
+    GlyphAtlas* getGlyphAtlas(SDL_Renderer* renderer, const std::string& fontId);
+    bool measureText(SDL_Renderer* renderer, const std::string& text, const std::string& fontId, int& width, int& height);
+    void flushText(SDL_Renderer* renderer);
     
     // System state
     AssetManager& assetManager;
@@ -121,14 +134,43 @@ private:
     PerformanceMetrics metrics;
     std::chrono::high_resolution_clock::time_point frameStartTime;
     
-    // Text rendering cache
-    std::unordered_map<std::string, SDL_Texture*> textCache;
+    // Text rendering: one glyph atlas per (renderer, font id); a null entry marks a font that failed to load.
+    // Consecutive text draws share one geometry batch, flushed before any other draw call to keep z-order.
+    std::map<std::pair<SDL_Renderer*, std::string>, std::unique_ptr<GlyphAtlas>> glyphAtlases;
+    std::vector<SDL_Vertex> textVertices;
+    std::vector<int> textIndices;
+    SDL_Texture* textBatchTexture = nullptr;
     
     // UI element sorting (by z-order)
     std::vector<Entity> sortedUIElements;
     
+    // Retained layer cache, keyed by (renderer, subtree root)
+    struct LayerCacheEntry {
+        SDL_Texture* texture = nullptr;
+        std::vector<Entity> members;      // Subtree in draw order
+        size_t visualHash = 0;
+        SDL_Rect bounds = {0, 0, 0, 0};   // Relative to the root's absolute position
+        int changedFrames = 0;
+        int stableFrames = 0;
+        bool isVolatile = false;          // Changes every frame, cheaper to draw directly
+        bool dirty = true;
+        bool seenThisFrame = false;
+    };
+    std::map<std::pair<SDL_Renderer*, Entity>, LayerCacheEntry> layerCache;
+    std::vector<Entity> layerOwner;       // Per entity: cached root it is drawn into, or NO_ENTITY
+    bool rootCachingEnabled = true;
+    bool premultipliedBlendSupported = true;   // Cleared if the renderer rejects the layer blend mode
+    SDL_Point renderOffset = {0, 0};      // Subtracted from all draw coordinates while baking
+    
+    void updateLayerCache(SDL_Renderer* renderer, ComponentManager* componentManager);
+    bool isLayerCandidate(const UIComponent& ui) const;
+    void collectSubtree(Entity entity, ComponentManager* componentManager, std::vector<Entity>& out);
+    size_t computeVisualHash(Entity entity, const UIComponent& root, ComponentManager* componentManager);
+    SDL_Rect computeElementBounds(SDL_Renderer* renderer, Entity entity, const UIComponent& ui, ComponentManager* componentManager);
+    bool bakeLayer(SDL_Renderer* renderer, Entity root, LayerCacheEntry& entry, ComponentManager* componentManager);
+    void compositeLayer(SDL_Renderer* renderer, Entity root, const LayerCacheEntry& entry, ComponentManager* componentManager);
+    
     // Helper methods
     void sortUIElementsByZOrder(ComponentManager* componentManager);
     void clearTextCache();
-    std::string getTextCacheKey(const std::string& text, const SDL_Color& color, const std::string& fontId);
 };
@@ -0,0 +1,282 @@
+#include "EventPayload.h"
+#include <cstring>
+#include <deque>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace {
+    // Keys are views of the stored names, so lookups by string_view never build a std::string
+    struct NameTable {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string_view, EventNameId> ids;
+        std::deque<std::string> names;   // Deque keeps references stable as names are added
+
+        NameTable() {
+            names.emplace_back();
+            ids.emplace(names.front(), NO_EVENT_NAME);
+        }
+    };
+
+    NameTable& nameTable() {
+        static NameTable table;
+        return table;
+    }
+
+    // Per-thread direct-mapped cache of resolved names. Names are never removed, so a hit needs no lock.
+    struct CachedName {
+        const std::string* name = nullptr;
+        EventNameId id = NO_EVENT_NAME;
+    };
+    constexpr size_t NAME_CACHE_SIZE = 64;
+    thread_local std::array<CachedName, NAME_CACHE_SIZE> nameCache;
+
+    CachedName& cacheSlot(size_t hash) {
+        return nameCache[hash & (NAME_CACHE_SIZE - 1)];
+    }
+
+    // Looks the name up under a shared lock; caches and returns the id if present
+    bool findShared(NameTable& table, std::string_view name, CachedName& slot, EventNameId& id) {
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        auto it = table.ids.find(name);
+        if (it == table.ids.end()) return false;
+        id = it->second;
+        slot = {&table.names[id], id};
+        return true;
+    }
+}
+
+EventNameId EventNames::intern(std::string_view name) {
+    if (name.empty()) return NO_EVENT_NAME;
+    CachedName& slot = cacheSlot(std::hash<std::string_view>()(name));
+    if (slot.name && *slot.name == name) return slot.id;
+
+    NameTable& table = nameTable();
+    EventNameId id;
+    if (findShared(table, name, slot, id)) return id;
+
+    std::unique_lock<std::shared_mutex> lock(table.mutex);
+    auto it = table.ids.find(name);   // Another thread may have added it meanwhile
+    if (it == table.ids.end()) {
+        table.names.emplace_back(name);
+        it = table.ids.emplace(table.names.back(), static_cast<EventNameId>(table.names.size() - 1)).first;
+    }
+    slot = {&table.names[it->second], it->second};
+    return it->second;
+}
+
+EventNameId EventNames::find(std::string_view name) {
+    if (name.empty()) return NO_EVENT_NAME;
+    CachedName& slot = cacheSlot(std::hash<std::string_view>()(name));
+    if (slot.name && *slot.name == name) return slot.id;
+
+    EventNameId id;
+    return findShared(nameTable(), name, slot, id) ? id : UNKNOWN_EVENT_NAME;
+}
+
+const std::string& EventNames::name(EventNameId id) {
+    NameTable& table = nameTable();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    return id < table.names.size() ? table.names[id] : table.names[NO_EVENT_NAME];
+}
+
+size_t EventNames::count() {
+    NameTable& table = nameTable();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    return table.names.size();
+}
+
+EventOverflowArena& EventOverflowArena::instance() {
+    static EventOverflowArena arena;
+    return arena;
+}
+
+EventOverflowBlock* EventOverflowArena::acquire() {
+    std::lock_guard<std::mutex> lock(mutex);
+    EventOverflowBlock* block;
+    if (!freeBlocks.empty()) {
+        block = freeBlocks.back();
+        freeBlocks.pop_back();
+    } else {
+        blocks.push_back(std::make_unique<EventOverflowBlock>());
+        block = blocks.back().get();
+    }
+    block->refs.store(1, std::memory_order_relaxed);
+    return block;
+}
+
+void EventOverflowArena::retain(EventOverflowBlock* block) {
+    block->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventOverflowArena::release(EventOverflowBlock* block) {
+    if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(mutex);
+        freeBlocks.push_back(block);
+    }
+}
+
+size_t EventOverflowArena::blocksAllocated() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return blocks.size();
+}
+
+size_t EventOverflowArena::blocksInUse() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return blocks.size() - freeBlocks.size();
+}
+
+EventPayload::EventPayload(const EventPayload& other)
+    : params(other.params), count(other.count),
+      inlineTextUsed(other.inlineTextUsed), overflowUsed(other.overflowUsed),
+      overflow(other.overflow) {
+    std::memcpy(inlineText, other.inlineText, inlineTextUsed);
+    if (overflow) EventOverflowArena::instance().retain(overflow);
+}
+
+EventPayload::EventPayload(EventPayload&& other) noexcept
+    : params(other.params), count(other.count),
+      inlineTextUsed(other.inlineTextUsed), overflowUsed(other.overflowUsed),
+      overflow(other.overflow) {
+    std::memcpy(inlineText, other.inlineText, inlineTextUsed);
+    other.overflow = nullptr;
+    other.clear();
+}
+
+EventPayload& EventPayload::operator=(const EventPayload& other) {
+    if (this == &other) return *this;
+    if (other.overflow) EventOverflowArena::instance().retain(other.overflow);
+    releaseOverflow();
+    params = other.params;
+    count = other.count;
+    inlineTextUsed = other.inlineTextUsed;
+    overflowUsed = other.overflowUsed;
+    overflow = other.overflow;
+    std::memcpy(inlineText, other.inlineText, inlineTextUsed);
+    return *this;
+}
+
+EventPayload& EventPayload::operator=(EventPayload&& other) noexcept {
+    if (this == &other) return *this;
+    releaseOverflow();
+    params = other.params;
+    count = other.count;
+    inlineTextUsed = other.inlineTextUsed;
+    overflowUsed = other.overflowUsed;
+    overflow = other.overflow;
+    std::memcpy(inlineText, other.inlineText, inlineTextUsed);
+    other.overflow = nullptr;
+    other.clear();
+    return *this;
+}
+
+EventPayload::~EventPayload() {
+    releaseOverflow();
+}
+
+void EventPayload::releaseOverflow() {
+    if (overflow) {
+        EventOverflowArena::instance().release(overflow);
+        overflow = nullptr;
+    }
+    overflowUsed = 0;
+}
+
+void EventPayload::clear() {
+    releaseOverflow();
+    count = 0;
+    inlineTextUsed = 0;
+}
+
+EventParam* EventPayload::slot(EventNameId key) {
+    for (int i = 0; i < count; ++i) {
+        if (params[i].key == key) return &params[i];
+    }
+    if (count >= MAX_PARAMS) return nullptr;
+    EventParam& param = params[count++];
+    param.key = key;
+    return &param;
+}
+
+const EventParam* EventPayload::find(EventNameId key) const {
+    for (int i = 0; i < count; ++i) {
+        if (params[i].key == key) return &params[i];
+    }
+    return nullptr;
+}
+
+bool EventPayload::setInt(EventNameId key, int value) {
+    EventParam* param = slot(key);
+    if (!param) return false;
+    param->type = EventParamType::INT;
+    param->i = value;
+    return true;
+}
+
+bool EventPayload::setFloat(EventNameId key, float value) {
+    EventParam* param = slot(key);
+    if (!param) return false;
+    param->type = EventParamType::FLOAT;
+    param->f = value;
+    return true;
+}
+
+bool EventPayload::setEntity(EventNameId key, Entity value) {
+    EventParam* param = slot(key);
+    if (!param) return false;
+    param->type = EventParamType::ENTITY;
+    param->entity = value;
+    return true;
+}
+
+bool EventPayload::setVec2(EventNameId key, float x, float y) {
+    EventParam* param = slot(key);
+    if (!param) return false;
+    param->type = EventParamType::VEC2;
+    param->vec2 = {x, y};
+    return true;
+}
+
+bool EventPayload::setText(EventNameId key, std::string_view value) {
+    EventParam* param = slot(key);
+    if (!param) return false;
+
+    // Rewriting a key appends the new text; the old bytes stay unused until the payload is cleared
+    size_t length = value.size();
+    bool complete = true;
+    if (length <= INLINE_TEXT_CAPACITY - inlineTextUsed) {
+        if (length > 0) std::memcpy(inlineText + inlineTextUsed, value.data(), length);
+        param->text = {inlineTextUsed, static_cast<std::uint16_t>(length)};
+        inlineTextUsed = static_cast<std::uint16_t>(inlineTextUsed + length);
+    } else {
+        EventOverflowArena& arena = EventOverflowArena::instance();
+        if (!overflow) {
+            overflow = arena.acquire();
+            overflowUsed = 0;
+        } else if (overflow->refs.load(std::memory_order_acquire) > 1) {
+            // Shared with a copy of this event: copy on write
+            EventOverflowBlock* owned = arena.acquire();
+            std::memcpy(owned->bytes, overflow->bytes, overflowUsed);
+            arena.release(overflow);
+            overflow = owned;
+        }
+        size_t room = EventOverflowBlock::CAPACITY - overflowUsed;
+        if (length > room) {
+            length = room;
+            complete = false;
+        }
+        if (length > 0) std::memcpy(overflow->bytes + overflowUsed, value.data(), length);
+        param->text = {static_cast<std::uint16_t>(INLINE_TEXT_CAPACITY + overflowUsed), static_cast<std::uint16_t>(length)};
+        overflowUsed = static_cast<std::uint16_t>(overflowUsed + length);
+    }
+    param->type = EventParamType::TEXT;
+    return complete;
+}
+
+std::string_view EventPayload::text(const EventParam& param) const {
+    if (param.type != EventParamType::TEXT) return {};
+    if (param.text.offset < INLINE_TEXT_CAPACITY) {
+        return std::string_view(inlineText + param.text.offset, param.text.length);
+    }
+    if (!overflow) return {};
+    return std::string_view(overflow->bytes + (param.text.offset - INLINE_TEXT_CAPACITY), param.text.length);
+}
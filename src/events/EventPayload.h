@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../ecs/Entity.h"
+
+using EventNameId = std::uint32_t;
+const EventNameId NO_EVENT_NAME = 0;                  // The empty name
+const EventNameId UNKNOWN_EVENT_NAME = 0xFFFFFFFFu;   // Returned by find() for names never interned
+
+// Process-wide interning of event names and parameter keys. Ids never change once handed out,
+// so hot paths can intern their names once and compare integers afterwards. Thread-safe; repeat
+// lookups are served from a per-thread cache and only new names take the exclusive lock.
+class EventNames {
+public:
+    static EventNameId intern(std::string_view name);
+    static EventNameId find(std::string_view name);
+    static const std::string& name(EventNameId id);
+    static size_t count();
+};
+
+// Spill storage for event text that does not fit inline. Blocks are pooled and reference
+// counted, so copying an event shares its block and steady-state traffic allocates nothing.
+struct EventOverflowBlock {
+    static const size_t CAPACITY = 1024;
+    std::atomic<int> refs{0};
+    char bytes[CAPACITY];
+};
+
+class EventOverflowArena {
+public:
+    static EventOverflowArena& instance();
+
+    EventOverflowBlock* acquire();   // Returned with one reference
+    void retain(EventOverflowBlock* block);
+    void release(EventOverflowBlock* block);
+
+    size_t blocksAllocated() const;
+    size_t blocksInUse() const;
+
+private:
+    EventOverflowArena() = default;
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<EventOverflowBlock>> blocks;
+    std::vector<EventOverflowBlock*> freeBlocks;
+};
+
+enum class EventParamType : std::uint8_t {
+    NONE,
+    INT,
+    FLOAT,
+    ENTITY,
+    VEC2,
+    TEXT
+};
+
+struct EventVec2 {
+    float x;
+    float y;
+};
+
+struct EventParam {
+    struct TextRef {
+        std::uint16_t offset;   // Offsets past the inline buffer address the overflow block
+        std::uint16_t length;
+    };
+
+    EventNameId key = NO_EVENT_NAME;
+    EventParamType type = EventParamType::NONE;
+    union {
+        int i = 0;
+        float f;
+        Entity entity;
+        EventVec2 vec2;
+        TextRef text;
+    };
+};
+
+// Fixed-size parameter set carried by every event: a handful of typed values stored inline,
+// short strings in an inline buffer, long strings in a shared overflow block.
+class EventPayload {
+public:
+    static const int MAX_PARAMS = 8;
+    static const size_t INLINE_TEXT_CAPACITY = 48;
+
+    EventPayload() = default;
+    EventPayload(const EventPayload& other);
+    EventPayload(EventPayload&& other) noexcept;
+    EventPayload& operator=(const EventPayload& other);
+    EventPayload& operator=(EventPayload&& other) noexcept;
+    ~EventPayload();
+
+    // Setters overwrite an existing key; they return false when the payload is full
+    // (or, for text, when the value had to be truncated)
+    bool setInt(EventNameId key, int value);
+    bool setFloat(EventNameId key, float value);
+    bool setEntity(EventNameId key, Entity value);
+    bool setVec2(EventNameId key, float x, float y);
+    bool setText(EventNameId key, std::string_view value);
+
+    const EventParam* find(EventNameId key) const;
+    std::string_view text(const EventParam& param) const;
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    const EventParam& at(int index) const { return params[index]; }
+    bool usesOverflow() const { return overflow != nullptr; }
+    void clear();
+
+private:
+    EventParam* slot(EventNameId key);
+    void releaseOverflow();
+
+    std::array<EventParam, MAX_PARAMS> params;
+    std::uint8_t count = 0;
+    std::uint16_t inlineTextUsed = 0;
+    std::uint16_t overflowUsed = 0;
+    char inlineText[INLINE_TEXT_CAPACITY];
+    EventOverflowBlock* overflow = nullptr;
+};
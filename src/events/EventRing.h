@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Bounded multi-producer, single-consumer queue. Any thread may push without locking; only
+// the owning thread may pop. Values are moved in and out of preallocated cells, and a push
+// into a full ring fails instead of blocking or growing. Capacity is rounded up to a power of two.
+template <typename T>
+class MPSCRing {
+public:
+    explicit MPSCRing(size_t requestedCapacity) {
+        size_t capacity = 2;
+        while (capacity < requestedCapacity) capacity <<= 1;
+        mask = capacity - 1;
+        cells.reset(new Cell[capacity]);
+        for (size_t i = 0; i < capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCRing(const MPSCRing&) = delete;
+    MPSCRing& operator=(const MPSCRing&) = delete;
+
+    bool tryPush(T&& value) {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (difference < 0) {
+                return false; // Full: the consumer has not freed this cell yet
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only
+    bool tryPop(T& out) {
+        Cell& cell = cells[dequeuePosition & mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(dequeuePosition + 1) < 0) {
+            return false;
+        }
+        out = std::move(cell.value);
+        cell.sequence.store(dequeuePosition + mask + 1, std::memory_order_release);
+        ++dequeuePosition;
+        return true;
+    }
+
+    // Consumer thread only; producers may be mid-push, so this is a snapshot
+    size_t sizeApprox() const {
+        return enqueuePosition.load(std::memory_order_relaxed) - dequeuePosition;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> enqueuePosition{0};
+    alignas(64) size_t dequeuePosition = 0;
+};
+
+// Fixed-capacity history that overwrites its oldest entry. Storage is allocated once, on the
+// first push after a capacity change; index 0 is the oldest entry.
+template <typename T>
+class HistoryRing {
+public:
+    HistoryRing() = default;
+    explicit HistoryRing(size_t capacity) : limit(capacity) {}
+
+    void setCapacity(size_t capacity) {
+        if (capacity == limit) return;
+        limit = capacity;
+        clear();
+        std::vector<T>().swap(entries);
+    }
+
+    void push(const T& value) {
+        if (limit == 0) return;
+        if (entries.size() < limit) {
+            if (entries.capacity() < limit) entries.reserve(limit);
+            entries.push_back(value);
+            return;
+        }
+        entries[head] = value;
+        head = (head + 1) % limit;
+    }
+
+    const T& operator[](size_t index) const { return entries[(head + index) % entries.size()]; }
+    const T& newest() const { return (*this)[entries.size() - 1]; }
+
+    size_t size() const { return entries.size(); }
+    size_t capacity() const { return limit; }
+    bool empty() const { return entries.empty(); }
+
+    void clear() {
+        entries.clear();
+        head = 0;
+    }
+
+private:
+    std::vector<T> entries;
+    size_t head = 0;   // Oldest entry once the ring is full
+    size_t limit = 0;
+};
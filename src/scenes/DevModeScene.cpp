@@ -82,6 +82,7 @@ DevModeScene::DevModeScene(SDL_Renderer* ren, SDL_Window* win)
     componentManager->registerComponent<UIInputFieldComponent>();
     componentManager->registerComponent<UIPanelComponent>();
     componentManager->registerComponent<UIImageComponent>();
+    componentManager->registerComponent<TilemapComponent>();
     loadDevModeScene(*this, sceneFilePath);
 
     renderSystem = systemManager->registerSystem<RenderSystem>();
@@ -96,6 +97,7 @@ DevModeScene::DevModeScene(SDL_Renderer* ren, SDL_Window* win)
     eventSystem = systemManager->registerSystem<EventSystem>();
     stateMachineSystem = systemManager->registerSystem<StateMachineSystem>();
     uiSystem = systemManager->registerSystem<UISystem>();
+    tilemapSystem = systemManager->registerSystem<TilemapSystem>();
 
     scriptSystem->setLoggingFunctions(
         [this](const std::string& msg) { this->addLogToConsole(msg); },
@@ -155,10 +157,14 @@ DevModeScene::DevModeScene(SDL_Renderer* ren, SDL_Window* win)
     particleSig.set(componentManager->getComponentType<ParticleEmitterComponent>());
     particleSig.set(componentManager->getComponentType<ParticleComponent>());
     systemManager->setSignature<ParticleSystem>(particleSig);
+    particleSystem->initEffectPool(entityManager.get(), componentManager.get(), systemManager.get());
+    scriptSystem->setParticleSystem(particleSystem.get());
 
     Signature eventSig;
     eventSig.set(componentManager->getComponentType<EventComponent>());
     systemManager->setSignature<EventSystem>(eventSig);
+    scriptSystem->setEventSystem(eventSystem.get());
+    scriptSystem->setHotReloadEnabled(true);
 
     Signature stateMachineSig;
     stateMachineSig.set(componentManager->getComponentType<StateMachineComponent>());
@@ -168,6 +174,11 @@ DevModeScene::DevModeScene(SDL_Renderer* ren, SDL_Window* win)
     uiSig.set(componentManager->getComponentType<UIComponent>());
     systemManager->setSignature<UISystem>(uiSig);
 
+    Signature tilemapSig;
+    tilemapSig.set(componentManager->getComponentType<TransformComponent>());
+    tilemapSig.set(componentManager->getComponentType<TilemapComponent>());
+    systemManager->setSignature<TilemapSystem>(tilemapSig);
+
     AssetManager& assets = AssetManager::getInstance();
     std::string texturePath = "../assets/Textures/";
     if (std::filesystem::exists(texturePath)) {
@@ -319,7 +330,18 @@ void DevModeScene::update(float deltaTime) {
 
     // 4. Collision (detects and resolves collisions, can alter transforms and velocities)
     if (collisionSystem) {
+        if (tilemapSystem) {
+            tilemapSystem->update(componentManager.get());
+            collisionSystem->setStaticColliders(tilemapSystem->getStaticColliders());
+        }
         collisionSystem->update(componentManager.get(), deltaTime);
+
+        // Particles collide with the static part of the same world
+        if (particleSystem) {
+            static const std::vector<StaticCollider> noStaticColliders;
+            particleSystem->updateCollisionWorld(componentManager.get(), collisionSystem->entities,
+                                                 tilemapSystem ? tilemapSystem->getStaticColliders() : noStaticColliders);
+        }
     }
 
     // 5. Animation
@@ -351,8 +373,16 @@ void DevModeScene::update(float deltaTime) {
         uiSystem->update(componentManager.get(), deltaTime);
     }
 
-    // 10. Particles
+    // 10. Particles, with LOD against what the game window shows this frame
     if (particleSystem) {
+        if (gameWindow) {
+            int gameWindowW, gameWindowH;
+            SDL_GetWindowSize(gameWindow, &gameWindowW, &gameWindowH);
+            float viewX, viewY, viewZoom;
+            resolveGameCamera(viewX, viewY, viewZoom);
+            if (viewZoom <= 0.0f) viewZoom = 1.0f;
+            particleSystem->setView(viewX, viewY, gameWindowW / viewZoom, gameWindowH / viewZoom);
+        }
         particleSystem->update(componentManager.get(), deltaTime);
     }
 
@@ -543,6 +573,10 @@ void DevModeScene::render() {
             }
         }
 
+        if (tilemapSystem && componentManager) {
+            tilemapSystem->render(renderer, componentManager.get(), currentRenderCameraX, currentRenderCameraY, currentRenderZoom);
+        }
+
         std::vector<Entity> entitiesToRender;
         if (entityManager) { 
             for (auto entity : entityManager->getActiveEntities()) {
@@ -1037,6 +1071,144 @@ void DevModeScene::render() {
 
             ImGui::EndTabItem();
         }
+        if (ImGui::BeginTabItem("Performance")) {
+            if (scriptSystem) {
+                const auto& scriptMetrics = scriptSystem->getMetrics();
+                ImGui::Text("Scripts: %d instances, %.3f ms", scriptMetrics.scriptInstances, scriptMetrics.updateTime);
+                ImGui::Text("Coroutines: %d active, %d resumed this frame", scriptMetrics.activeCoroutines, scriptMetrics.coroutinesResumed);
+                ImGui::Text("Workers: %d parallel entities, %.3f ms waiting, %d commands, %d messages",
+                            scriptMetrics.workerEntities, scriptMetrics.workerWaitTime, scriptMetrics.workerCommands, scriptMetrics.messagesDelivered);
+                const auto workerMetrics = scriptSystem->getWorkerMetrics();
+                for (size_t i = 0; i < workerMetrics.size(); ++i) {
+                    ImGui::Text("  Worker %zu: %d entities (%d suspended), %.3f ms", i, workerMetrics[i].entities, workerMetrics[i].suspended, workerMetrics[i].updateTime);
+                }
+                int workerCount = scriptSystem->getWorkerCount();
+                if (ImGui::InputInt("Script workers", &workerCount)) {
+                    scriptSystem->setWorkerCount(workerCount);
+                }
+                bool hotReload = scriptSystem->isHotReloadEnabled();
+                if (ImGui::Checkbox("Hot reload scripts", &hotReload)) {
+                    scriptSystem->setHotReloadEnabled(hotReload);
+                }
+                ImGui::SameLine();
+                ImGui::Text("%d reloaded, %d failed", scriptMetrics.scriptsReloaded, scriptMetrics.reloadFailures);
+                ScriptSandbox::Limits sandboxLimits = scriptSystem->getSandboxLimits();
+                bool sandboxChanged = ImGui::Checkbox("Script limits", &sandboxLimits.enabled);
+                int budgetMillions = static_cast<int>(sandboxLimits.instructionBudget / 1000000);
+                if (ImGui::SliderInt("Instructions per call (M)", &budgetMillions, 1, 500)) {
+                    sandboxLimits.instructionBudget = static_cast<std::uint64_t>(budgetMillions) * 1000000;
+                    sandboxChanged = true;
+                }
+                int memoryLimitMB = static_cast<int>(sandboxLimits.memoryLimitBytes / (1024 * 1024));
+                if (ImGui::SliderInt("Lua memory limit (MB)", &memoryLimitMB, 16, 2048)) {
+                    sandboxLimits.memoryLimitBytes = static_cast<size_t>(memoryLimitMB) * 1024 * 1024;
+                    sandboxChanged = true;
+                }
+                if (sandboxChanged) {
+                    scriptSystem->setSandboxLimits(sandboxLimits);
+                }
+                ImGui::Text("Suspended scripts: %d (%d limit violations)", scriptMetrics.suspendedScripts, scriptMetrics.sandboxViolations);
+                ImGui::SameLine();
+                if (ImGui::Button("Resume Suspended")) {
+                    scriptSystem->resumeSuspendedScripts();
+                }
+                ImGui::Text("Lua heap: %.1f KB (peak %.1f KB)", scriptMetrics.heapBytes / 1024.0f, scriptMetrics.peakHeapBytes / 1024.0f);
+                ImGui::Text("Lua GC: %.3f ms, %d steps, %.1f KB collected this frame", scriptMetrics.gcStepTime, scriptMetrics.gcSteps, scriptMetrics.collectedBytes / 1024.0f);
+                ImGui::Text("Lua GC cycles: %d (%d emergency)", scriptMetrics.gcCyclesCompleted, scriptMetrics.gcEmergencyCollections);
+
+                ScriptSystem::GCSettings gcSettings = scriptSystem->getGCSettings();
+                bool gcChanged = false;
+                gcChanged |= ImGui::Checkbox("Budgeted GC", &gcSettings.budgeted);
+                ImGui::SameLine();
+                gcChanged |= ImGui::Checkbox("Generational", &gcSettings.generational);
+                gcChanged |= ImGui::SliderFloat("GC budget (ms)", &gcSettings.stepBudgetMs, 0.1f, 5.0f, "%.1f");
+                gcChanged |= ImGui::SliderInt("GC step (KB)", &gcSettings.stepSizeKB, 1, 256);
+                if (gcChanged) {
+                    scriptSystem->setGCSettings(gcSettings);
+                }
+                if (ImGui::Button("Reset Script Metrics")) {
+                    scriptSystem->resetMetrics();
+                }
+
+                if (ImGui::CollapsingHeader("Script Profiler")) {
+                    ScriptProfiler& profiler = scriptSystem->getProfiler();
+                    bool profiling = scriptSystem->isProfilingEnabled();
+                    if (ImGui::Checkbox("Profile scripts", &profiling)) {
+                        scriptSystem->setProfilingEnabled(profiling);
+                    }
+                    ImGui::SameLine();
+                    if (ImGui::Button("Reset Profile")) {
+                        profiler.reset();
+                    }
+                    ImGui::SameLine();
+                    if (ImGui::Button("Export Trace")) {
+                        const std::string tracePath = "script_profile.json";
+                        if (profiler.exportTrace(tracePath)) {
+                            addLogToConsole("Exported script profile to " + tracePath);
+                        } else {
+                            addLogToConsole("Error: Could not write script profile to " + tracePath);
+                        }
+                    }
+                    int profiledFrames = std::max(profiler.getFrameCount(), 1);
+                    ImGui::Text("%d frames profiled, %zu trace events dropped", profiler.getFrameCount(), profiler.getDroppedEvents());
+
+                    const ImGuiTableFlags tableFlags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY;
+                    const float tableHeight = ImGui::GetTextLineHeightWithSpacing() * 8;
+                    if (ImGui::BeginTable("ProfilerScripts", 5, tableFlags, ImVec2(0, tableHeight))) {
+                        ImGui::TableSetupColumn("Script");
+                        ImGui::TableSetupColumn("Entities");
+                        ImGui::TableSetupColumn("Calls/frame");
+                        ImGui::TableSetupColumn("ms/frame");
+                        ImGui::TableSetupColumn("KB alloc/frame");
+                        ImGui::TableHeadersRow();
+                        for (const auto& stats : profiler.getScriptStats()) {
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn(); ImGui::TextUnformatted(stats.scriptPath.c_str());
+                            ImGui::TableNextColumn(); ImGui::Text("%d", stats.entities);
+                            ImGui::TableNextColumn(); ImGui::Text("%.1f", static_cast<double>(stats.calls) / profiledFrames);
+                            ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.totalMs / profiledFrames);
+                            ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.allocatedBytes / 1024.0 / profiledFrames);
+                        }
+                        ImGui::EndTable();
+                    }
+                    if (ImGui::BeginTable("ProfilerFunctions", 6, tableFlags, ImVec2(0, tableHeight))) {
+                        ImGui::TableSetupColumn("Function");
+                        ImGui::TableSetupColumn("Source");
+                        ImGui::TableSetupColumn("Calls/frame");
+                        ImGui::TableSetupColumn("Self ms/frame");
+                        ImGui::TableSetupColumn("Total ms/frame");
+                        ImGui::TableSetupColumn("KB alloc/frame");
+                        ImGui::TableHeadersRow();
+                        for (const auto& stats : profiler.getFunctionStats()) {
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn(); ImGui::TextUnformatted(stats.name.c_str());
+                            ImGui::TableNextColumn(); ImGui::Text("%s:%d", stats.source.c_str(), stats.line);
+                            ImGui::TableNextColumn(); ImGui::Text("%.1f", static_cast<double>(stats.calls) / profiledFrames);
+                            ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.selfMs / profiledFrames);
+                            ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.totalMs / profiledFrames);
+                            ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.allocatedBytes / 1024.0 / profiledFrames);
+                        }
+                        ImGui::EndTable();
+                    }
+                    if (ImGui::BeginTable("ProfilerEntities", 4, tableFlags, ImVec2(0, tableHeight))) {
+                        ImGui::TableSetupColumn("Entity");
+                        ImGui::TableSetupColumn("Script");
+                        ImGui::TableSetupColumn("ms/frame");
+                        ImGui::TableSetupColumn("KB alloc/frame");
+                        ImGui::TableHeadersRow();
+                        for (const auto& stats : profiler.getEntityStats()) {
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn(); ImGui::Text("%u", stats.entity);
+                            ImGui::TableNextColumn(); ImGui::TextUnformatted(stats.scriptPath.c_str());
+                            ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.totalMs / profiledFrames);
+                            ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.allocatedBytes / 1024.0 / profiledFrames);
+                        }
+                        ImGui::EndTable();
+                    }
+                }
+            }
+            ImGui::EndTabItem();
+        }
         if (ImGui::BeginTabItem("Console")) {
             if (ImGui::Button("Clear")) {
                 consoleLogBuffer.clear();
@@ -1252,6 +1424,12 @@ void DevModeScene::cleanupGameWindow() {
     gameTextures.clear();
 
     if (gameRenderer) {
+        if (tilemapSystem) {
+            tilemapSystem->releaseRenderer(gameRenderer);
+        }
+        if (uiSystem) {
+            uiSystem->releaseRenderer(gameRenderer);
+        }
         SDL_DestroyRenderer(gameRenderer);
         gameRenderer = nullptr;
     }
@@ -1262,18 +1440,10 @@ void DevModeScene::cleanupGameWindow() {
     }
 }
 
-void DevModeScene::renderGameWindow() {
-    if (!gameWindow || !gameRenderer) return;
-
-    int gameWindowW, gameWindowH;
-    SDL_GetWindowSize(gameWindow, &gameWindowW, &gameWindowH);
-
-    SDL_Rect gameViewportRect = {0, 0, gameWindowW, gameWindowH};
-    SDL_RenderSetViewport(gameRenderer, &gameViewportRect);
-
-    float currentRenderCameraX = 0.0f;
-    float currentRenderCameraY = 0.0f;
-    float currentRenderZoom = 1.0f;
+void DevModeScene::resolveGameCamera(float& outCameraX, float& outCameraY, float& outZoom) {
+    outCameraX = 0.0f;
+    outCameraY = 0.0f;
+    outZoom = 1.0f;
 
     if (gameCameraEntity != 0 &&
         componentManager->hasComponent<TransformComponent>(gameCameraEntity) &&
@@ -1283,9 +1453,9 @@ void DevModeScene::renderGameWindow() {
         auto& cameraComp = componentManager->getComponent<CameraComponent>(gameCameraEntity);
 
         if (cameraComp.isActive) {
-            currentRenderCameraX = cameraTransform.x;
-            currentRenderCameraY = cameraTransform.y;
-            currentRenderZoom = cameraComp.zoom;
+            outCameraX = cameraTransform.x;
+            outCameraY = cameraTransform.y;
+            outZoom = cameraComp.zoom;
         }
     }
 
@@ -1296,11 +1466,26 @@ void DevModeScene::renderGameWindow() {
         Entity activeCamEntity = cameraSystem->getActiveCameraEntity();
 
         if (activeCamEntity != NO_ENTITY) {
-            currentRenderCameraX = static_cast<float>(activeGameCameraWorldView.x);
-            currentRenderCameraY = static_cast<float>(activeGameCameraWorldView.y);
-            currentRenderZoom = gameCamZoom;
+            outCameraX = static_cast<float>(activeGameCameraWorldView.x);
+            outCameraY = static_cast<float>(activeGameCameraWorldView.y);
+            outZoom = gameCamZoom;
         }
     }
+}
+
+void DevModeScene::renderGameWindow() {
+    if (!gameWindow || !gameRenderer) return;
+
+    int gameWindowW, gameWindowH;
+    SDL_GetWindowSize(gameWindow, &gameWindowW, &gameWindowH);
+
+    SDL_Rect gameViewportRect = {0, 0, gameWindowW, gameWindowH};
+    SDL_RenderSetViewport(gameRenderer, &gameViewportRect);
+
+    float currentRenderCameraX = 0.0f;
+    float currentRenderCameraY = 0.0f;
+    float currentRenderZoom = 1.0f;
+    resolveGameCamera(currentRenderCameraX, currentRenderCameraY, currentRenderZoom);
 
     SDL_SetRenderDrawColor(gameRenderer,
                           (Uint8)(clear_color.x * 255),
@@ -1309,6 +1494,10 @@ void DevModeScene::renderGameWindow() {
                           (Uint8)(clear_color.w * 255));
     SDL_RenderClear(gameRenderer);
 
+    if (tilemapSystem) {
+        tilemapSystem->render(gameRenderer, componentManager.get(), currentRenderCameraX, currentRenderCameraY, currentRenderZoom, &gameTextures);
+    }
+
     std::vector<Entity> entitiesToRender;
     if (entityManager) {
         for (auto entity : entityManager->getActiveEntities()) {
@@ -25,6 +25,7 @@
 #include "../ecs/components/EventComponent.h"
 #include "../ecs/components/StateMachineComponent.h"
 #include "../ecs/components/UIComponent.h"
+#include "../ecs/components/TilemapComponent.h"
 #include "../ecs/systems/RenderSystem.h"
 #include "../ecs/systems/ScriptSystem.h"
 #include "../ecs/systems/MovementSystem.h"
@@ -37,6 +38,7 @@
 #include "../ecs/systems/EventSystem.h"
 #include "../ecs/systems/StateMachineSystem.h"
 #include "../ecs/systems/UISystem.h"
+#include "../ecs/systems/TilemapSystem.h"
 #include "../AssetManager.h"
 #include "../ecs/Entity.h"
 #include "../../vendor/nlohmann/json.hpp"
@@ -59,6 +61,7 @@ class ParticleSystem;
 class EventSystem;
 class StateMachineSystem;
 class UISystem;
+class TilemapSystem;
 class AIPromptProcessor;
 
 const int HANDLE_SIZE = 8; 
@@ -98,6 +101,11 @@ public:
      */
     void renderGameWindow();
 
+    /**
+     * @brief World position and zoom of the camera the game window shows this frame
+     */
+    void resolveGameCamera(float& outCameraX, float& outCameraY, float& outZoom);
+
     /**
      * @brief Load textures for the game window renderer
      */
@@ -149,6 +157,7 @@ public:
     std::shared_ptr<EventSystem> eventSystem;
     std::shared_ptr<StateMachineSystem> stateMachineSystem;
     std::shared_ptr<UISystem> uiSystem;
+    std::shared_ptr<TilemapSystem> tilemapSystem;
 
     std::vector<std::string> consoleLogBuffer;
 
@@ -11,6 +11,8 @@
 #include "../ecs/components/NameComponent.h"
 #include "../ecs/components/AudioComponent.h"
 #include "../ecs/components/CameraComponent.h" 
+#include "../ecs/components/TilemapComponent.h"
+#include "../ecs/components/ParticleComponent.h"
 #include "../AssetManager.h"
 #include "tinyfiledialogs.h"
 #include <fstream>
@@ -25,6 +27,11 @@ void saveDevModeScene(DevModeScene& scene, const std::string& filepath) {
 
     const auto& activeEntities = scene.entityManager->getActiveEntities();
     for (Entity entity : activeEntities) {
+        // Effect pool entities belong to the ParticleSystem and are recreated on demand
+        if (scene.componentManager->hasComponent<ParticleComponent>(entity) &&
+            scene.componentManager->getComponent<ParticleComponent>(entity).pooled) {
+            continue;
+        }
         nlohmann::json entityJson;
         entityJson["id_saved"] = entity; 
         entityJson["components"] = nlohmann::json::object();
@@ -62,6 +69,16 @@ void saveDevModeScene(DevModeScene& scene, const std::string& filepath) {
         if (scene.componentManager->hasComponent<RigidbodyComponent>(entity)) {
             entityJson["components"]["RigidbodyComponent"] = scene.componentManager->getComponent<RigidbodyComponent>(entity);
         }
+        if (scene.componentManager->hasComponent<TilemapComponent>(entity)) {
+            entityJson["components"]["TilemapComponent"] = scene.componentManager->getComponent<TilemapComponent>(entity);
+        }
+        if (scene.componentManager->hasComponent<ParticleEmitterComponent>(entity)) {
+            entityJson["components"]["ParticleEmitterComponent"] = scene.componentManager->getComponent<ParticleEmitterComponent>(entity);
+        }
+        if (scene.componentManager->hasComponent<ParticleComponent>(entity)) {
+            // Live particles are runtime state; only the component's presence is saved
+            entityJson["components"]["ParticleComponent"] = nlohmann::json::object();
+        }
 
         if (!entityJson["components"].empty()) {
             sceneJson["entities"].push_back(entityJson);
@@ -223,6 +240,21 @@ bool loadDevModeScene(DevModeScene& scene, const std::string& filepath) {
                     from_json(componentData, comp);
                     scene.componentManager->addComponent(newEntity, comp);
                     entitySignature.set(scene.componentManager->getComponentType<RigidbodyComponent>());
+                } else if (componentType == "TilemapComponent") {
+                    TilemapComponent comp;
+                    from_json(componentData, comp);
+                    scene.componentManager->addComponent(newEntity, comp);
+                    entitySignature.set(scene.componentManager->getComponentType<TilemapComponent>());
+                } else if (componentType == "ParticleEmitterComponent") {
+                    ParticleEmitterComponent comp;
+                    from_json(componentData, comp);
+                    scene.componentManager->addComponent(newEntity, comp);
+                    entitySignature.set(scene.componentManager->getComponentType<ParticleEmitterComponent>());
+                } else if (componentType == "ParticleComponent") {
+                    ParticleComponent comp;
+                    comp.reserveParticles(100); // Same default as the inspector
+                    scene.componentManager->addComponent(newEntity, comp);
+                    entitySignature.set(scene.componentManager->getComponentType<ParticleComponent>());
                 } else {
                     std::cerr << "Warning: Unknown component type '" << componentType << "' encountered during loading." << std::endl;
                 }
@@ -16,6 +16,7 @@
 #include "../ecs/components/ParticleComponent.h"
 #include "../ecs/components/EventComponent.h"
 #include "../ecs/components/StateMachineComponent.h"
+#include "../ecs/components/TilemapComponent.h"
 #include "../AssetManager.h"
 #include "../utils/FileUtils.h" 
 #include "../utils/EditorHelpers.h" 
@@ -41,7 +42,7 @@ void renderInspectorPanel(DevModeScene& scene, ImGuiIO& io) {
         ImGui::Separator();
 
         ImGui::PushItemWidth(-1);
-        const char* component_types[] = { "Transform", "Sprite", "Velocity", "Script", "Collider", "Animation", "Audio", "SoundEffects", "Camera", "Rigidbody", "ParticleEmitter", "Particle", "Event", "StateMachine" };
+        const char* component_types[] = { "Transform", "Sprite", "Velocity", "Script", "Collider", "Animation", "Audio", "SoundEffects", "Camera", "Rigidbody", "ParticleEmitter", "Particle", "Event", "StateMachine", "Tilemap" };
         static int current_component_type_idx = 0;
 
         if (ImGui::BeginCombo("##AddComponentCombo", component_types[current_component_type_idx])) {
@@ -195,6 +196,16 @@ void renderInspectorPanel(DevModeScene& scene, ImGuiIO& io) {
                 } else {
                     std::cout << "Entity " << scene.selectedEntity << " already has StateMachineComponent." << std::endl;
                 }
+            } else if (selected_component_str == "Tilemap") {
+                if (!scene.componentManager->hasComponent<TilemapComponent>(scene.selectedEntity)) {
+                    TilemapComponent tilemap;
+                    tilemap.resize(32, 32);
+                    scene.componentManager->addComponent(scene.selectedEntity, tilemap);
+                    entitySignature.set(scene.componentManager->getComponentType<TilemapComponent>());
+                    std::cout << "Added TilemapComponent to Entity " << scene.selectedEntity << std::endl;
+                } else {
+                    std::cout << "Entity " << scene.selectedEntity << " already has TilemapComponent." << std::endl;
+                }
             }
 
             scene.entityManager->setSignature(scene.selectedEntity, entitySignature);
@@ -622,9 +633,12 @@ void renderInspectorPanel(DevModeScene& scene, ImGuiIO& io) {
                 ImGui::Checkbox("Enabled", &emitter.enabled);
                 ImGui::DragFloat("Emission Rate", &emitter.emissionRate, 1.0f, 0.1f, 1000.0f);
                 ImGui::DragInt("Max Particles", &emitter.maxParticles, 1, 1, 10000);
+                ImGui::DragInt("Budget Priority", &emitter.priority, 1, -100, 100);
                 ImGui::Checkbox("Looping", &emitter.looping);
                 if (!emitter.looping) {
                     ImGui::DragFloat("Duration", &emitter.duration, 0.1f, 0.1f, 60.0f);
+                } else {
+                    ImGui::Checkbox("Prewarm", &emitter.prewarm);
                 }
 
                 ImGui::Separator();
@@ -662,6 +676,16 @@ void renderInspectorPanel(DevModeScene& scene, ImGuiIO& io) {
                 ImGui::DragFloat("Gravity Y", &emitter.gravityY, 1.0f, -1000.0f, 1000.0f);
                 ImGui::DragFloat("Damping", &emitter.damping, 0.01f, 0.0f, 1.0f);
 
+                const char* collisionModes[] = {"None", "Bounce", "Die", "Stick"};
+                int currentCollision = static_cast<int>(emitter.collisionMode);
+                if (ImGui::Combo("World Collision", &currentCollision, collisionModes, IM_ARRAYSIZE(collisionModes))) {
+                    emitter.collisionMode = static_cast<ParticleCollisionMode>(currentCollision);
+                }
+                if (emitter.collisionMode == ParticleCollisionMode::BOUNCE) {
+                    ImGui::DragFloat("Bounciness", &emitter.bounciness, 0.01f, 0.0f, 1.0f);
+                    ImGui::DragFloat("Collision Friction", &emitter.collisionFriction, 0.01f, 0.0f, 1.0f);
+                }
+
                 ImGui::Separator();
                 ImGui::Text("Visual Properties");
                 ImGui::InputText("Texture ID", const_cast<char*>(emitter.textureId.c_str()), emitter.textureId.capacity() + 1);
@@ -724,12 +748,79 @@ void renderInspectorPanel(DevModeScene& scene, ImGuiIO& io) {
             }
         }
 
+        if (scene.componentManager->hasComponent<TilemapComponent>(scene.selectedEntity)) {
+            if (ImGui::CollapsingHeader("Tilemap Component", ImGuiTreeNodeFlags_DefaultOpen)) {
+                auto& tilemap = scene.componentManager->getComponent<TilemapComponent>(scene.selectedEntity);
+
+                static char tilesetBuffer[256] = "";
+                static Entity tilesetBufferEntity = NO_ENTITY;
+                if (tilesetBufferEntity != scene.selectedEntity) {
+                    strncpy(tilesetBuffer, tilemap.tilesetTextureId.c_str(), IM_ARRAYSIZE(tilesetBuffer) - 1);
+                    tilesetBuffer[IM_ARRAYSIZE(tilesetBuffer) - 1] = '\0';
+                    tilesetBufferEntity = scene.selectedEntity;
+                }
+                if (ImGui::InputText("Tileset Texture##Tilemap", tilesetBuffer, IM_ARRAYSIZE(tilesetBuffer), ImGuiInputTextFlags_EnterReturnsTrue)) {
+                    std::string newTilesetId(tilesetBuffer);
+                    AssetManager& assets = AssetManager::getInstance();
+                    if (assets.getTexture(newTilesetId) || assets.loadTexture(newTilesetId, newTilesetId)) {
+                        tilemap.tilesetTextureId = newTilesetId;
+                        tilemap.markLayoutChanged();
+                        scene.reloadGameTextures();
+                    } else {
+                        std::cerr << "Inspector Error: Failed to find or load tileset: '" << newTilesetId << "'. Reverting." << std::endl;
+                        strncpy(tilesetBuffer, tilemap.tilesetTextureId.c_str(), IM_ARRAYSIZE(tilesetBuffer) - 1);
+                    }
+                }
+
+                bool layoutChanged = false;
+                layoutChanged |= ImGui::DragInt("Tile Width##Tilemap", &tilemap.tileWidth, 1.0f, 1, 512);
+                layoutChanged |= ImGui::DragInt("Tile Height##Tilemap", &tilemap.tileHeight, 1.0f, 1, 512);
+                layoutChanged |= ImGui::DragInt("Tileset Columns##Tilemap", &tilemap.tilesetColumns, 1.0f, 1, 256);
+                if (layoutChanged) {
+                    tilemap.markLayoutChanged();
+                }
+
+                int mapSize[2] = { tilemap.width, tilemap.height };
+                if (ImGui::InputInt2("Map Size (tiles)##Tilemap", mapSize, ImGuiInputTextFlags_EnterReturnsTrue)) {
+                    tilemap.resize(mapSize[0], mapSize[1]);
+                }
+
+                static int fillTileId = 0;
+                ImGui::InputInt("Tile ID##TilemapFill", &fillTileId);
+                if (ImGui::Button("Fill##Tilemap")) {
+                    tilemap.fill(fillTileId);
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Clear##Tilemap")) {
+                    tilemap.fill(TILE_EMPTY);
+                }
+
+                if (ImGui::Checkbox("Generate Collision##Tilemap", &tilemap.generateCollision)) {
+                    tilemap.collisionDirty = true;
+                }
+                if (ImGui::Checkbox("All Tiles Solid##Tilemap", &tilemap.allTilesSolid)) {
+                    tilemap.collisionDirty = true;
+                }
+
+                ImGui::Text("Chunks: %d x %d (%d tiles each)", tilemap.chunksX, tilemap.chunksY, TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE);
+                ImGui::Text("Merged Collision Rects: %zu", tilemap.collisionRects.size());
+
+                if (ImGui::Button("Remove Tilemap Component")) {
+                    scene.componentManager->removeComponent<TilemapComponent>(scene.selectedEntity);
+                    Signature sig = scene.entityManager->getSignature(scene.selectedEntity);
+                    sig.reset(scene.componentManager->getComponentType<TilemapComponent>());
+                    scene.entityManager->setSignature(scene.selectedEntity, sig);
+                    scene.systemManager->entitySignatureChanged(scene.selectedEntity, sig);
+                }
+            }
+        }
+
         // ParticleComponent Inspector (read-only info)
         if (scene.componentManager->hasComponent<ParticleComponent>(scene.selectedEntity)) {
             if (ImGui::CollapsingHeader("Particle Component (Info)", ImGuiTreeNodeFlags_DefaultOpen)) {
                 auto& particleComp = scene.componentManager->getComponent<ParticleComponent>(scene.selectedEntity);
 
-                ImGui::Text("Total Particles: %zu", particleComp.particles.size());
+                ImGui::Text("Total Particles: %d", particleComp.capacity());
                 ImGui::Text("Active Particles: %d", particleComp.activeParticleCount);
                 ImGui::Text("Particles Emitted This Frame: %d", particleComp.particlesEmittedThisFrame);
 
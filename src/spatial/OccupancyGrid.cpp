@@ -0,0 +1,47 @@
+#include "OccupancyGrid.h"
+#include <algorithm>
+
+void OccupancyGrid::build(const std::vector<SDL_FRect>& solids, float requestedCellSize) {
+    clear();
+    if (solids.empty()) return;
+
+    float minX = solids[0].x, minY = solids[0].y;
+    float maxX = solids[0].x + solids[0].w, maxY = solids[0].y + solids[0].h;
+    for (const auto& rect : solids) {
+        minX = std::min(minX, rect.x);
+        minY = std::min(minY, rect.y);
+        maxX = std::max(maxX, rect.x + rect.w);
+        maxY = std::max(maxY, rect.y + rect.h);
+    }
+
+    // Coarsen the cells rather than let a sprawling world blow up memory
+    cellSize = std::max(1.0f, requestedCellSize);
+    float extent = std::max(maxX - minX, maxY - minY);
+    if (extent / cellSize > MAX_CELLS_PER_AXIS) {
+        cellSize = extent / MAX_CELLS_PER_AXIS;
+    }
+    invCellSize = 1.0f / cellSize;
+    originX = minX;
+    originY = minY;
+    width = std::max(1, static_cast<int>(std::ceil((maxX - minX) * invCellSize)));
+    height = std::max(1, static_cast<int>(std::ceil((maxY - minY) * invCellSize)));
+    cells.assign(static_cast<size_t>(width) * height, 0);
+
+    for (const auto& rect : solids) {
+        if (rect.w <= 0.0f || rect.h <= 0.0f) continue;
+        int x0 = std::clamp(static_cast<int>(std::floor((rect.x - originX) * invCellSize)), 0, width - 1);
+        int y0 = std::clamp(static_cast<int>(std::floor((rect.y - originY) * invCellSize)), 0, height - 1);
+        int x1 = std::clamp(static_cast<int>(std::ceil((rect.x + rect.w - originX) * invCellSize)) - 1, x0, width - 1);
+        int y1 = std::clamp(static_cast<int>(std::ceil((rect.y + rect.h - originY) * invCellSize)) - 1, y0, height - 1);
+        for (int y = y0; y <= y1; ++y) {
+            std::fill(cells.begin() + static_cast<size_t>(y) * width + x0,
+                      cells.begin() + static_cast<size_t>(y) * width + x1 + 1, uint8_t{1});
+        }
+    }
+}
+
+void OccupancyGrid::clear() {
+    cells.clear();
+    width = 0;
+    height = 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Coarse solid/empty grid baked from static rectangles. A point query is one array read,
+// which makes it usable for per-particle collision where tree queries would be too slow.
+class OccupancyGrid {
+public:
+    // Cells touched by any rectangle are solid; the grid covers the union of the rectangles
+    void build(const std::vector<SDL_FRect>& solids, float cellSize);
+    void clear();
+
+    bool empty() const { return cells.empty(); }
+    float getCellSize() const { return cellSize; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // Points outside the grid are empty
+    bool isSolid(float x, float y) const {
+        int cellX = static_cast<int>(std::floor((x - originX) * invCellSize));
+        int cellY = static_cast<int>(std::floor((y - originY) * invCellSize));
+        if (cellX < 0 || cellY < 0 || cellX >= width || cellY >= height) return false;
+        return cells[static_cast<size_t>(cellY) * width + cellX] != 0;
+    }
+
+private:
+    static const int MAX_CELLS_PER_AXIS = 4096;
+
+    std::vector<uint8_t> cells;
+    float originX = 0.0f;
+    float originY = 0.0f;
+    float cellSize = 8.0f;
+    float invCellSize = 1.0f / 8.0f;
+    int width = 0;
+    int height = 0;
+};
@@ -0,0 +1,161 @@
+#include "GlyphAtlas.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+bool GlyphAtlas::build(SDL_Renderer* renderer, TTF_Font* font) {
+    if (!renderer || !font) return false;
+    releaseTexture();
+    glyphs.fill(Glyph{});
+
+    lineHeight = TTF_FontHeight(font);
+    lineSkip = TTF_FontLineSkip(font);
+
+    struct RasterizedGlyph {
+        int codepoint;
+        SDL_Surface* surface;
+    };
+    std::vector<RasterizedGlyph> rasterized;
+    const SDL_Color white = {255, 255, 255, 255};
+
+    for (int codepoint = FIRST_GLYPH; codepoint <= LAST_GLYPH; ++codepoint) {
+        if (codepoint >= 127 && codepoint < 160) continue; // Control characters
+        if (!TTF_GlyphIsProvided(font, static_cast<Uint16>(codepoint))) continue;
+
+        int minX, maxX, minY, maxY, advance;
+        if (TTF_GlyphMetrics(font, static_cast<Uint16>(codepoint), &minX, &maxX, &minY, &maxY, &advance) != 0) continue;
+
+        Glyph& glyph = glyphs[codepoint];
+        glyph.present = true;
+        glyph.advance = advance;
+        // Same placement TTF_RenderText uses: the pen starts at -minX when a glyph overhangs left
+        glyph.offsetX = std::min(0, minX);
+
+        if (codepoint == ' ') continue;
+        SDL_Surface* surface = TTF_RenderGlyph_Blended(font, static_cast<Uint16>(codepoint), white);
+        if (surface) {
+            rasterized.push_back({codepoint, surface});
+        }
+    }
+
+    // Shelf packing, one row per line height with a pixel of padding to avoid bleeding
+    int penX = 1;
+    int penY = 1;
+    int rowHeight = 0;
+    for (auto& entry : rasterized) {
+        if (penX + entry.surface->w + 1 > ATLAS_WIDTH) {
+            penX = 1;
+            penY += rowHeight + 1;
+            rowHeight = 0;
+        }
+        glyphs[entry.codepoint].src = {penX, penY, entry.surface->w, entry.surface->h};
+        penX += entry.surface->w + 1;
+        rowHeight = std::max(rowHeight, entry.surface->h);
+    }
+    textureWidth = ATLAS_WIDTH;
+    textureHeight = penY + rowHeight + 1;
+
+    SDL_Surface* atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, textureWidth, textureHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!atlasSurface) {
+        std::cerr << "[GlyphAtlas] Failed to create atlas surface: " << SDL_GetError() << std::endl;
+        for (auto& entry : rasterized) SDL_FreeSurface(entry.surface);
+        return false;
+    }
+    SDL_FillRect(atlasSurface, nullptr, SDL_MapRGBA(atlasSurface->format, 0, 0, 0, 0));
+
+    for (auto& entry : rasterized) {
+        // Copy coverage as-is instead of blending it onto the transparent atlas
+        SDL_SetSurfaceBlendMode(entry.surface, SDL_BLENDMODE_NONE);
+        SDL_Rect dest = glyphs[entry.codepoint].src;
+        SDL_BlitSurface(entry.surface, nullptr, atlasSurface, &dest);
+        SDL_FreeSurface(entry.surface);
+    }
+
+    texture = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+    SDL_FreeSurface(atlasSurface);
+    if (!texture) {
+        std::cerr << "[GlyphAtlas] Failed to create atlas texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void GlyphAtlas::releaseTexture() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+}
+
+const GlyphAtlas::Glyph& GlyphAtlas::getGlyph(std::uint32_t codepoint) const {
+    if (codepoint <= static_cast<std::uint32_t>(LAST_GLYPH) && glyphs[codepoint].present) {
+        return glyphs[codepoint];
+    }
+    return glyphs['?'];
+}
+
+void GlyphAtlas::measure(const std::string& text, int& width, int& height) const {
+    // The pen advances as in layout(); a glyph's overhang only widens the line it ends
+    int penX = 0;
+    int lineWidth = 0;
+    int maxWidth = 0;
+    int lines = text.empty() ? 0 : 1;
+    size_t i = 0;
+    while (i < text.size()) {
+        std::uint32_t codepoint = nextCodepoint(text, i);
+        if (codepoint == '\n') {
+            maxWidth = std::max(maxWidth, lineWidth);
+            penX = 0;
+            lineWidth = 0;
+            lines++;
+            continue;
+        }
+        const Glyph& glyph = getGlyph(codepoint);
+        lineWidth = std::max(lineWidth, penX + glyph.offsetX + glyph.src.w);
+        penX += glyph.advance;
+        lineWidth = std::max(lineWidth, penX);
+    }
+    width = std::max(maxWidth, lineWidth);
+    height = lines > 0 ? lineHeight + (lines - 1) * lineSkip : 0;
+}
+
+int GlyphAtlas::measurePrefix(const std::string& text, size_t byteCount) const {
+    int penX = 0;
+    size_t i = 0;
+    byteCount = std::min(byteCount, text.size());
+    while (i < byteCount) {
+        std::uint32_t codepoint = nextCodepoint(text, i);
+        if (codepoint == '\n') {
+            penX = 0;
+            continue;
+        }
+        penX += getGlyph(codepoint).advance;
+    }
+    return penX;
+}
+
+// Minimal UTF-8 decoder; malformed bytes are returned as-is (treated as Latin-1)
+std::uint32_t GlyphAtlas::nextCodepoint(const std::string& text, size_t& index) {
+    unsigned char lead = static_cast<unsigned char>(text[index]);
+    int extraBytes = 0;
+    std::uint32_t codepoint = lead;
+    if (lead >= 0xF0) { extraBytes = 3; codepoint = lead & 0x07; }
+    else if (lead >= 0xE0) { extraBytes = 2; codepoint = lead & 0x0F; }
+    else if (lead >= 0xC0) { extraBytes = 1; codepoint = lead & 0x1F; }
+
+    if (extraBytes > 0 && index + extraBytes >= text.size()) {
+        index++;
+        return lead;
+    }
+    for (int b = 1; b <= extraBytes; ++b) {
+        unsigned char next = static_cast<unsigned char>(text[index + b]);
+        if ((next & 0xC0) != 0x80) {
+            index++;
+            return lead;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    index += extraBytes + 1;
+    return codepoint;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <array>
+#include <string>
+#include <cstdint>
+
+// Pre-rasterized glyphs of one font packed into a single texture. Text is laid out from the
+// cached metrics, so drawing a changing string costs no TTF rasterization or surface allocation.
+// Covers Latin-1 (the range TTF_RenderText used to support); other code points map to '?'.
+class GlyphAtlas {
+public:
+    struct Glyph {
+        SDL_Rect src = {0, 0, 0, 0};  // Cell in the atlas texture (empty for blank glyphs)
+        int offsetX = 0;              // Cell position relative to the pen
+        int advance = 0;
+        bool present = false;
+    };
+
+    GlyphAtlas() = default;
+    // The texture belongs to the renderer; call releaseTexture() before destroying the renderer
+    ~GlyphAtlas() = default;
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    bool build(SDL_Renderer* renderer, TTF_Font* font);
+    void releaseTexture();
+
+    SDL_Texture* getTexture() const { return texture; }
+    int getTextureWidth() const { return textureWidth; }
+    int getTextureHeight() const { return textureHeight; }
+    int getLineHeight() const { return lineHeight; }
+
+    // Size of the text block; '\n' starts a new line
+    void measure(const std::string& text, int& width, int& height) const;
+    int measurePrefix(const std::string& text, size_t byteCount) const;
+
+    // Calls emit(const Glyph&, float x, float y) for every visible glyph, with (x, y) the top-left of its cell
+    template <typename EmitFn>
+    void layout(const std::string& text, float x, float y, EmitFn&& emit) const {
+        float penX = x;
+        float penY = y;
+        size_t i = 0;
+        while (i < text.size()) {
+            std::uint32_t codepoint = nextCodepoint(text, i);
+            if (codepoint == '\n') {
+                penX = x;
+                penY += lineSkip;
+                continue;
+            }
+            const Glyph& glyph = getGlyph(codepoint);
+            if (glyph.src.w > 0 && glyph.src.h > 0) {
+                emit(glyph, penX + glyph.offsetX, penY);
+            }
+            penX += glyph.advance;
+        }
+    }
+
+    const Glyph& getGlyph(std::uint32_t codepoint) const;
+    static std::uint32_t nextCodepoint(const std::string& text, size_t& index);
+
+private:
+    static const int FIRST_GLYPH = 32;
+    static const int LAST_GLYPH = 255;
+    static const int ATLAS_WIDTH = 512;
+
+    std::array<Glyph, LAST_GLYPH + 1> glyphs;
+    SDL_Texture* texture = nullptr;
+    int textureWidth = 0;
+    int textureHeight = 0;
+    int lineHeight = 0;
+    int lineSkip = 0;
+};
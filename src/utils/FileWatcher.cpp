@@ -0,0 +1,124 @@
+#include "FileWatcher.h"
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+FileWatcher::FileWatcher() {
+#ifdef __linux__
+    notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notifyFd < 0) {
+        std::cerr << "[FileWatcher] inotify unavailable, falling back to polling modification times" << std::endl;
+    }
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if (notifyFd >= 0) close(notifyFd);
+#endif
+}
+
+std::string FileWatcher::normalize(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+    return (ec ? std::filesystem::path(path) : absolute).lexically_normal().string();
+}
+
+void FileWatcher::watch(const std::string& path) {
+    std::string key = normalize(path);
+    if (files.count(key)) return;
+
+    std::error_code ec;
+    WatchedFile file{path, std::filesystem::last_write_time(path, ec)};
+    files.emplace(key, file);
+
+#ifdef __linux__
+    if (notifyFd < 0) return;
+    std::string directory = std::filesystem::path(key).parent_path().string();
+    if (directoryWatches.count(directory)) return;
+    int wd = inotify_add_watch(notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (wd < 0) {
+        std::cerr << "[FileWatcher] Could not watch directory " << directory << ", polling " << path << " instead" << std::endl;
+        files[key].polled = true;
+        polledFiles++;
+        return;
+    }
+    watchDirectories[wd] = directory;
+    directoryWatches[directory] = wd;
+#endif
+}
+
+void FileWatcher::unwatchAll() {
+#ifdef __linux__
+    for (const auto& [wd, directory] : watchDirectories) {
+        inotify_rm_watch(notifyFd, wd);
+    }
+#endif
+    watchDirectories.clear();
+    directoryWatches.clear();
+    files.clear();
+    polledFiles = 0;
+}
+
+void FileWatcher::poll(std::vector<std::string>& changedFiles) {
+    size_t firstNew = changedFiles.size();
+    if (notifyFd >= 0) {
+        readNotifications(changedFiles);
+    }
+    if (notifyFd < 0 || polledFiles > 0) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastScan >= pollInterval) {
+            lastScan = now;
+            scanWriteTimes(changedFiles);
+        }
+    }
+
+    // A save often produces several events for the same file
+    std::sort(changedFiles.begin() + firstNew, changedFiles.end());
+    changedFiles.erase(std::unique(changedFiles.begin() + firstNew, changedFiles.end()), changedFiles.end());
+}
+
+void FileWatcher::scanWriteTimes(std::vector<std::string>& changedFiles) {
+    for (auto& [key, file] : files) {
+        if (notifyFd >= 0 && !file.polled) continue;   // Reported by inotify
+        std::error_code ec;
+        auto writeTime = std::filesystem::last_write_time(file.path, ec);
+        if (!ec && writeTime != file.writeTime) {
+            file.writeTime = writeTime;
+            changedFiles.push_back(file.path);
+        }
+    }
+}
+
+void FileWatcher::readNotifications(std::vector<std::string>& changedFiles) {
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        ssize_t length = read(notifyFd, buffer, sizeof(buffer));
+        if (length <= 0) break; // EAGAIN: nothing pending
+
+        for (char* cursor = buffer; cursor < buffer + length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+            cursor += sizeof(inotify_event) + event->len;
+            if (event->len == 0) continue;
+
+            auto directory = watchDirectories.find(event->wd);
+            if (directory == watchDirectories.end()) continue;
+            std::string key = (std::filesystem::path(directory->second) / event->name).lexically_normal().string();
+            auto file = files.find(key);
+            if (file == files.end()) continue;
+
+            std::error_code ec;
+            file->second.writeTime = std::filesystem::last_write_time(file->second.path, ec);
+            changedFiles.push_back(file->second.path);
+        }
+    }
+#else
+    (void)changedFiles;
+#endif
+}
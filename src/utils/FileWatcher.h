@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+#include <chrono>
+
+// Reports files that changed on disk since the last poll. On Linux this uses inotify on the
+// files' directories, which also catches editors that save by writing a temporary file and
+// renaming it over the original; elsewhere (or if inotify is unavailable) modification times
+// are compared, at most every pollInterval. Files whose directory cannot be watched are polled
+// the same way alongside the notifications.
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    void watch(const std::string& path);
+    void unwatchAll();
+
+    // Appends each changed file once, as the path it was watched under
+    void poll(std::vector<std::string>& changedFiles);
+
+    bool usingNotifications() const { return notifyFd >= 0; }
+    std::chrono::milliseconds pollInterval{500};
+
+private:
+    struct WatchedFile {
+        std::string path;                          // As passed to watch()
+        std::filesystem::file_time_type writeTime;
+        bool polled = false;                       // Directory could not be watched
+    };
+
+    std::unordered_map<std::string, WatchedFile> files;   // Keyed by normalized absolute path
+    std::chrono::steady_clock::time_point lastScan;
+    size_t polledFiles = 0;                               // Watched by modification time despite inotify
+
+    int notifyFd = -1;
+    std::unordered_map<int, std::string> watchDirectories;     // Watch descriptor -> directory
+    std::unordered_map<std::string, int> directoryWatches;
+
+    static std::string normalize(const std::string& path);
+    void scanWriteTimes(std::vector<std::string>& changedFiles);
+    void readNotifications(std::vector<std::string>& changedFiles);
+};
@@ -0,0 +1,543 @@
+// Headless render benchmark and golden-image regression check.
+//
+// Renders a scene with the SDL software renderer into an offscreen surface (no window, no GPU),
+// reports per-system render throughput and optionally compares frames against golden PNGs.
+//
+//   RenderBenchmark [--scene file.json] [--frames N] [--size WxH] [--seed N]
+//                   [--sprites N] [--emitters N] [--ui N] [--assets dir]
+//                   [--dump-dir dir] [--dump-every N]
+//                   [--golden-dir dir] [--update-golden] [--tolerance N] [--max-mismatch ratio]
+//                   [--json results.json]
+//
+// Without --scene a deterministic synthetic workload is generated (sprite grid, particle
+// emitters and a HUD). Exit code is 1 when any frame differs from its golden image, and
+// EXIT_GOLDEN_MISSING when none differs but some goldens do not exist yet (CTest reports a skip).
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../src/AssetManager.h"
+#include "../src/ecs/EntityManager.h"
+#include "../src/ecs/ComponentManager.h"
+#include "../src/ecs/SystemManager.h"
+#include "../src/ecs/components/TransformComponent.h"
+#include "../src/ecs/components/SpriteComponent.h"
+#include "../src/ecs/components/ParticleComponent.h"
+#include "../src/ecs/components/UIComponent.h"
+#include "../src/ecs/components/TilemapComponent.h"
+#include "../src/ecs/systems/RenderSystem.h"
+#include "../src/ecs/systems/ParticleSystem.h"
+#include "../src/ecs/systems/UISystem.h"
+#include "../src/ecs/systems/TilemapSystem.h"
+#include "../vendor/nlohmann/json.hpp"
+
+namespace fs = std::filesystem;
+
+struct BenchmarkOptions {
+    std::string scenePath;
+    std::string assetsDir = "../assets";
+    std::string dumpDir;
+    std::string goldenDir;
+    std::string jsonPath;
+    int frames = 300;
+    int width = 800;
+    int height = 600;
+    int dumpEvery = 60;
+    int sprites = 500;
+    int emitters = 8;
+    int uiElements = 40;
+    unsigned int seed = 1234;
+    int tolerance = 2;             // Max per-channel difference before a pixel counts as mismatched
+    double maxMismatch = 0.001;    // Fraction of mismatched pixels allowed per frame
+    bool updateGolden = false;
+};
+
+struct TimingStat {
+    std::string name;
+    double totalMs = 0.0;
+
+    double averageMs(int frames) const { return frames > 0 ? totalMs / frames : 0.0; }
+    double fps(int frames) const {
+        double avg = averageMs(frames);
+        return avg > 0.0 ? 1000.0 / avg : 0.0;
+    }
+};
+
+static bool parseArguments(int argc, char* argv[], BenchmarkOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "[RenderBenchmark] Missing value for " << name << std::endl;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        const char* value = nullptr;
+        if (arg == "--scene") { if (!(value = next("--scene"))) return false; options.scenePath = value; }
+        else if (arg == "--assets") { if (!(value = next("--assets"))) return false; options.assetsDir = value; }
+        else if (arg == "--frames") { if (!(value = next("--frames"))) return false; options.frames = std::atoi(value); }
+        else if (arg == "--size") {
+            if (!(value = next("--size"))) return false;
+            if (std::sscanf(value, "%dx%d", &options.width, &options.height) != 2) {
+                std::cerr << "[RenderBenchmark] --size expects WxH, got " << value << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--seed") { if (!(value = next("--seed"))) return false; options.seed = static_cast<unsigned int>(std::strtoul(value, nullptr, 10)); }
+        else if (arg == "--sprites") { if (!(value = next("--sprites"))) return false; options.sprites = std::atoi(value); }
+        else if (arg == "--emitters") { if (!(value = next("--emitters"))) return false; options.emitters = std::atoi(value); }
+        else if (arg == "--ui") { if (!(value = next("--ui"))) return false; options.uiElements = std::atoi(value); }
+        else if (arg == "--dump-dir") { if (!(value = next("--dump-dir"))) return false; options.dumpDir = value; }
+        else if (arg == "--dump-every") { if (!(value = next("--dump-every"))) return false; options.dumpEvery = std::max(1, std::atoi(value)); }
+        else if (arg == "--golden-dir") { if (!(value = next("--golden-dir"))) return false; options.goldenDir = value; }
+        else if (arg == "--update-golden") { options.updateGolden = true; }
+        else if (arg == "--tolerance") { if (!(value = next("--tolerance"))) return false; options.tolerance = std::atoi(value); }
+        else if (arg == "--max-mismatch") { if (!(value = next("--max-mismatch"))) return false; options.maxMismatch = std::atof(value); }
+        else if (arg == "--json") { if (!(value = next("--json"))) return false; options.jsonPath = value; }
+        else {
+            std::cerr << "[RenderBenchmark] Unknown argument: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.frames <= 0 || options.width <= 0 || options.height <= 0) {
+        std::cerr << "[RenderBenchmark] Frames and size must be positive" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Same id conventions as the editor: textures by stem and by path relative to Textures/, fonts as <stem>_16
+static void loadAssets(const std::string& assetsDir) {
+    AssetManager& assets = AssetManager::getInstance();
+    fs::path texturesRoot = fs::path(assetsDir) / "Textures";
+    if (fs::exists(texturesRoot)) {
+        for (const auto& entry : fs::recursive_directory_iterator(texturesRoot)) {
+            if (!entry.is_regular_file()) continue;
+            std::string path = entry.path().string();
+            assets.loadTexture(entry.path().stem().string(), path);
+            assets.loadTexture(fs::relative(entry.path(), texturesRoot).string(), path);
+        }
+    }
+    fs::path fontsRoot = fs::path(assetsDir) / "Fonts";
+    if (fs::exists(fontsRoot)) {
+        for (const auto& entry : fs::recursive_directory_iterator(fontsRoot)) {
+            std::string extension = entry.path().extension().string();
+            if (entry.is_regular_file() && (extension == ".ttf" || extension == ".otf")) {
+                assets.loadFont(entry.path().stem().string() + "_16", entry.path().string(), 16);
+            }
+        }
+    }
+}
+
+class BenchmarkScene {
+public:
+    std::unique_ptr<EntityManager> entityManager = std::make_unique<EntityManager>();
+    std::unique_ptr<ComponentManager> componentManager = std::make_unique<ComponentManager>();
+    std::unique_ptr<SystemManager> systemManager = std::make_unique<SystemManager>();
+    std::shared_ptr<RenderSystem> renderSystem;
+    std::shared_ptr<TilemapSystem> tilemapSystem;
+    std::shared_ptr<ParticleSystem> particleSystem;
+    std::shared_ptr<UISystem> uiSystem;
+
+    BenchmarkScene() {
+        componentManager->registerComponent<TransformComponent>();
+        componentManager->registerComponent<SpriteComponent>();
+        componentManager->registerComponent<TilemapComponent>();
+        componentManager->registerComponent<ParticleEmitterComponent>();
+        componentManager->registerComponent<ParticleComponent>();
+        componentManager->registerComponent<UIComponent>();
+        componentManager->registerComponent<UIPanelComponent>();
+        componentManager->registerComponent<UIButtonComponent>();
+        componentManager->registerComponent<UITextComponent>();
+
+        renderSystem = systemManager->registerSystem<RenderSystem>();
+        tilemapSystem = systemManager->registerSystem<TilemapSystem>();
+        particleSystem = systemManager->registerSystem<ParticleSystem>();
+        uiSystem = systemManager->registerSystem<UISystem>();
+
+        Signature renderSig;
+        renderSig.set(componentManager->getComponentType<TransformComponent>());
+        renderSig.set(componentManager->getComponentType<SpriteComponent>());
+        systemManager->setSignature<RenderSystem>(renderSig);
+
+        Signature tilemapSig;
+        tilemapSig.set(componentManager->getComponentType<TransformComponent>());
+        tilemapSig.set(componentManager->getComponentType<TilemapComponent>());
+        systemManager->setSignature<TilemapSystem>(tilemapSig);
+
+        Signature particleSig;
+        particleSig.set(componentManager->getComponentType<TransformComponent>());
+        particleSig.set(componentManager->getComponentType<ParticleEmitterComponent>());
+        particleSig.set(componentManager->getComponentType<ParticleComponent>());
+        systemManager->setSignature<ParticleSystem>(particleSig);
+
+        Signature uiSig;
+        uiSig.set(componentManager->getComponentType<UIComponent>());
+        systemManager->setSignature<UISystem>(uiSig);
+    }
+
+    template <typename T>
+    void add(Entity entity, const T& component) {
+        componentManager->addComponent(entity, component);
+        Signature signature = entityManager->getSignature(entity);
+        signature.set(componentManager->getComponentType<T>());
+        entityManager->setSignature(entity, signature);
+        systemManager->entitySignatureChanged(entity, signature);
+    }
+
+    void addEmitter(Entity entity, const ParticleEmitterComponent& emitter) {
+        ParticleComponent particles;
+        particles.reserveParticles(emitter.maxParticles);
+        add(entity, emitter);
+        add(entity, particles);
+    }
+
+    // Loads the render-relevant components of a scene saved by the editor
+    bool loadScene(const std::string& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "[RenderBenchmark] Could not open scene " << path << std::endl;
+            return false;
+        }
+        nlohmann::json sceneJson;
+        try {
+            file >> sceneJson;
+        } catch (nlohmann::json::parse_error& e) {
+            std::cerr << "[RenderBenchmark] Failed to parse scene " << path << ": " << e.what() << std::endl;
+            return false;
+        }
+        if (!sceneJson.contains("entities") || !sceneJson["entities"].is_array()) {
+            std::cerr << "[RenderBenchmark] Scene " << path << " has no 'entities' array" << std::endl;
+            return false;
+        }
+
+        for (const auto& entityJson : sceneJson["entities"]) {
+            if (!entityJson.contains("components")) continue;
+            const auto& components = entityJson["components"];
+            Entity entity = entityManager->createEntity();
+            if (components.contains("TransformComponent")) add(entity, components["TransformComponent"].get<TransformComponent>());
+            if (components.contains("SpriteComponent")) add(entity, components["SpriteComponent"].get<SpriteComponent>());
+            if (components.contains("TilemapComponent")) add(entity, components["TilemapComponent"].get<TilemapComponent>());
+            if (components.contains("ParticleEmitterComponent")) addEmitter(entity, components["ParticleEmitterComponent"].get<ParticleEmitterComponent>());
+        }
+        return true;
+    }
+
+    void buildSyntheticScene(const BenchmarkOptions& options) {
+        // Sprite grid using whichever textures are available, in a stable order
+        std::vector<std::string> textureIds;
+        for (const auto& texture : AssetManager::getInstance().getAllTextures()) {
+            if (texture.first.find('.') == std::string::npos) textureIds.push_back(texture.first);
+        }
+        std::sort(textureIds.begin(), textureIds.end());
+
+        if (!textureIds.empty()) {
+            int columns = std::max(1, static_cast<int>(std::sqrt(static_cast<float>(options.sprites))));
+            float cellW = static_cast<float>(options.width) / columns;
+            float cellH = static_cast<float>(options.height) / std::max(1, (options.sprites + columns - 1) / columns);
+            for (int i = 0; i < options.sprites; ++i) {
+                Entity entity = entityManager->createEntity();
+                add(entity, TransformComponent{(i % columns) * cellW, (i / columns) * cellH, cellW, cellH, static_cast<float>((i * 7) % 360), 0});
+                add(entity, SpriteComponent{textureIds[i % textureIds.size()]});
+            }
+        }
+
+        for (int i = 0; i < options.emitters; ++i) {
+            Entity entity = entityManager->createEntity();
+            float x = (i + 0.5f) * options.width / std::max(1, options.emitters);
+            add(entity, TransformComponent{x, options.height * 0.75f, 16.0f, 16.0f, 0.0f, 0});
+            switch (i % 3) {
+                case 0: addEmitter(entity, ParticleEffects::createFireEmitter()); break;
+                case 1: addEmitter(entity, ParticleEffects::createSmokeEmitter()); break;
+                default: addEmitter(entity, ParticleEffects::createSparkleEmitter()); break;
+            }
+        }
+
+        if (options.uiElements > 0) {
+            Entity panel = entityManager->createEntity();
+            UIComponent panelUI(UIElementType::PANEL);
+            panelUI.x = 10.0f;
+            panelUI.y = 10.0f;
+            panelUI.width = 260.0f;
+            panelUI.height = 20.0f + options.uiElements * 24.0f;
+            add(panel, panelUI);
+            add(panel, UIPanelComponent{});
+
+            for (int i = 0; i < options.uiElements; ++i) {
+                Entity element = entityManager->createEntity();
+                bool isButton = (i % 4) == 0;
+                UIComponent ui(isButton ? UIElementType::BUTTON : UIElementType::TEXT);
+                ui.x = 0.0f;
+                ui.y = i * 24.0f;
+                ui.width = 240.0f;
+                ui.height = 20.0f;
+                ui.zOrder = 1;
+                ui.parent = panel;
+                componentManager->getComponent<UIComponent>(panel).addChild(element);
+                add(element, ui);
+                if (isButton) add(element, UIButtonComponent{"Button " + std::to_string(i)});
+                else add(element, UITextComponent{"Label " + std::to_string(i)});
+            }
+            hudCounter = entityManager->createEntity();
+            UIComponent counterUI(UIElementType::TEXT);
+            counterUI.anchor = UIAnchor::TOP_RIGHT;
+            counterUI.x = 80.0f;
+            counterUI.y = 10.0f;
+            counterUI.zOrder = 2;
+            add(hudCounter, counterUI);
+            add(hudCounter, UITextComponent{"Frame 0"});
+        }
+    }
+
+    // A per-frame changing label, the typical score counter case
+    void updateDynamicContent(int frame) {
+        if (hudCounter != NO_ENTITY) {
+            componentManager->getComponent<UITextComponent>(hudCounter).text = "Frame " + std::to_string(frame);
+        }
+    }
+
+private:
+    Entity hudCounter = NO_ENTITY;
+};
+
+static SDL_Surface* toRGBA32(SDL_Surface* surface) {
+    return SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+}
+
+// Returns the fraction of pixels whose largest channel difference exceeds the tolerance,
+// or a negative value when the images cannot be compared
+static double compareImages(SDL_Surface* frame, SDL_Surface* golden, int tolerance, SDL_Surface* diffOut) {
+    if (frame->w != golden->w || frame->h != golden->h) return -1.0;
+
+    SDL_Surface* a = toRGBA32(frame);
+    SDL_Surface* b = toRGBA32(golden);
+    if (!a || !b) {
+        if (a) SDL_FreeSurface(a);
+        if (b) SDL_FreeSurface(b);
+        return -1.0;
+    }
+
+    long long mismatched = 0;
+    for (int y = 0; y < a->h; ++y) {
+        const Uint8* rowA = static_cast<const Uint8*>(a->pixels) + y * a->pitch;
+        const Uint8* rowB = static_cast<const Uint8*>(b->pixels) + y * b->pitch;
+        Uint8* rowDiff = diffOut ? static_cast<Uint8*>(diffOut->pixels) + y * diffOut->pitch : nullptr;
+        for (int x = 0; x < a->w; ++x) {
+            int maxDelta = 0;
+            for (int c = 0; c < 4; ++c) {
+                maxDelta = std::max(maxDelta, std::abs(rowA[x * 4 + c] - rowB[x * 4 + c]));
+            }
+            bool bad = maxDelta > tolerance;
+            if (bad) mismatched++;
+            if (rowDiff) {
+                // Mismatches in red over a dimmed copy of the frame
+                Uint8 gray = static_cast<Uint8>((rowA[x * 4] + rowA[x * 4 + 1] + rowA[x * 4 + 2]) / 12);
+                rowDiff[x * 4 + 0] = bad ? 255 : gray;
+                rowDiff[x * 4 + 1] = bad ? 0 : gray;
+                rowDiff[x * 4 + 2] = bad ? 0 : gray;
+                rowDiff[x * 4 + 3] = 255;
+            }
+        }
+    }
+
+    SDL_FreeSurface(a);
+    SDL_FreeSurface(b);
+    return static_cast<double>(mismatched) / (static_cast<double>(frame->w) * frame->h);
+}
+
+// Nothing differed, but there was nothing to compare against for some frames
+static const int EXIT_GOLDEN_MISSING = 77;
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        return 2;
+    }
+
+    // No video subsystem: everything renders into a plain surface
+    if (SDL_Init(0) != 0) {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    if (TTF_Init() == -1) {
+        std::cerr << "TTF_Init Error: " << TTF_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+    IMG_Init(IMG_INIT_PNG);
+
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, options.width, options.height, 32, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer) {
+        std::cerr << "[RenderBenchmark] Failed to create software renderer: " << SDL_GetError() << std::endl;
+        if (target) SDL_FreeSurface(target);
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    AssetManager::getInstance().init(renderer);
+    loadAssets(options.assetsDir);
+
+    auto scene = std::make_unique<BenchmarkScene>();
+    scene->particleSystem->setRandomSeed(options.seed);
+    scene->uiSystem->setScreenSize(options.width, options.height);
+    if (!options.scenePath.empty()) {
+        if (!scene->loadScene(options.scenePath)) {
+            SDL_DestroyRenderer(renderer);
+            SDL_FreeSurface(target);
+            TTF_Quit();
+            SDL_Quit();
+            return 1;
+        }
+    } else {
+        scene->buildSyntheticScene(options);
+    }
+
+    if (!options.dumpDir.empty()) fs::create_directories(options.dumpDir);
+    if (!options.goldenDir.empty() && options.updateGolden) fs::create_directories(options.goldenDir);
+
+    TimingStat renderStat{"RenderSystem"};
+    TimingStat tilemapStat{"TilemapSystem::render"};
+    TimingStat particleStat{"ParticleSystem::render"};
+    TimingStat uiStat{"UISystem::render"};
+    TimingStat frameStat{"Frame total"};
+    int goldenFailures = 0;
+    int goldenCompared = 0;
+    int goldenMissing = 0;
+    nlohmann::json frameResults = nlohmann::json::array();
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto elapsedMs = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    const float deltaTime = 1.0f / 60.0f;
+    for (int frame = 0; frame < options.frames; ++frame) {
+        scene->updateDynamicContent(frame);
+        scene->particleSystem->update(scene->componentManager.get(), deltaTime);
+        scene->uiSystem->update(scene->componentManager.get(), deltaTime);
+
+        auto frameStart = Clock::now();
+        SDL_SetRenderDrawColor(renderer, 30, 30, 40, 255);
+        SDL_RenderClear(renderer);
+
+        auto start = Clock::now();
+        scene->tilemapSystem->render(renderer, scene->componentManager.get(), 0.0f, 0.0f);
+        tilemapStat.totalMs += elapsedMs(start);
+
+        start = Clock::now();
+        scene->renderSystem->update(renderer, scene->componentManager.get(), 0.0f, 0.0f);
+        renderStat.totalMs += elapsedMs(start);
+
+        start = Clock::now();
+        scene->particleSystem->render(renderer, scene->componentManager.get(), 0.0f, 0.0f);
+        particleStat.totalMs += elapsedMs(start);
+
+        start = Clock::now();
+        scene->uiSystem->render(renderer, scene->componentManager.get());
+        uiStat.totalMs += elapsedMs(start);
+
+        SDL_RenderPresent(renderer);
+        frameStat.totalMs += elapsedMs(frameStart);
+
+        bool captureFrame = (frame + 1) % options.dumpEvery == 0 || frame == options.frames - 1;
+        if (!captureFrame || (options.dumpDir.empty() && options.goldenDir.empty())) continue;
+
+        std::ostringstream name;
+        name << "frame_" << std::setw(4) << std::setfill('0') << frame << ".png";
+
+        if (!options.dumpDir.empty()) {
+            std::string dumpPath = (fs::path(options.dumpDir) / name.str()).string();
+            if (IMG_SavePNG(target, dumpPath.c_str()) != 0) {
+                std::cerr << "[RenderBenchmark] Failed to write " << dumpPath << ": " << IMG_GetError() << std::endl;
+            }
+        }
+
+        if (!options.goldenDir.empty()) {
+            std::string goldenPath = (fs::path(options.goldenDir) / name.str()).string();
+            if (options.updateGolden) {
+                if (IMG_SavePNG(target, goldenPath.c_str()) != 0) {
+                    std::cerr << "[RenderBenchmark] Failed to write golden " << goldenPath << ": " << IMG_GetError() << std::endl;
+                }
+                continue;
+            }
+
+            SDL_Surface* golden = IMG_Load(goldenPath.c_str());
+            if (!golden) {
+                std::cerr << "[RenderBenchmark] Missing golden image " << goldenPath << std::endl;
+                goldenMissing++;
+                continue;
+            }
+            SDL_Surface* diff = options.dumpDir.empty() ? nullptr :
+                SDL_CreateRGBSurfaceWithFormat(0, options.width, options.height, 32, SDL_PIXELFORMAT_RGBA32);
+            double mismatch = compareImages(target, golden, options.tolerance, diff);
+            goldenCompared++;
+
+            bool passed = mismatch >= 0.0 && mismatch <= options.maxMismatch;
+            if (!passed) {
+                goldenFailures++;
+                std::cerr << "[RenderBenchmark] " << name.str() << " differs from golden: "
+                          << (mismatch < 0.0 ? std::string("size mismatch") : std::to_string(mismatch * 100.0) + "% of pixels") << std::endl;
+                if (diff) {
+                    std::string diffPath = (fs::path(options.dumpDir) / ("diff_" + name.str())).string();
+                    IMG_SavePNG(diff, diffPath.c_str());
+                }
+            }
+            frameResults.push_back({{"frame", frame}, {"mismatch", mismatch}, {"passed", passed}});
+            if (diff) SDL_FreeSurface(diff);
+            SDL_FreeSurface(golden);
+        }
+    }
+
+    const auto& particleMetrics = scene->particleSystem->getMetrics();
+    std::cout << "[RenderBenchmark] " << options.frames << " frames at " << options.width << "x" << options.height
+              << " (software renderer), " << particleMetrics.activeParticles << " active particles" << std::endl;
+    nlohmann::json systemResults = nlohmann::json::object();
+    for (const TimingStat* stat : {&renderStat, &tilemapStat, &particleStat, &uiStat, &frameStat}) {
+        std::cout << "  " << std::left << std::setw(26) << stat->name
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(9) << stat->averageMs(options.frames) << " ms"
+                  << std::setprecision(1) << std::setw(11) << stat->fps(options.frames) << " fps" << std::endl;
+        systemResults[stat->name] = {{"averageMs", stat->averageMs(options.frames)}, {"fps", stat->fps(options.frames)}};
+    }
+    if (goldenCompared > 0 || goldenMissing > 0) {
+        std::cout << "[RenderBenchmark] Golden images: " << (goldenCompared - goldenFailures)
+                  << " passed, " << goldenFailures << " failed, " << goldenMissing << " missing" << std::endl;
+    }
+
+    if (!options.jsonPath.empty()) {
+        nlohmann::json results = {
+            {"frames", options.frames},
+            {"width", options.width},
+            {"height", options.height},
+            {"systems", systemResults},
+            {"golden", {{"compared", goldenCompared}, {"failures", goldenFailures}, {"missing", goldenMissing}, {"frames", frameResults}}}
+        };
+        std::ofstream out(options.jsonPath);
+        out << results.dump(4) << std::endl;
+    }
+
+    scene.reset();
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    IMG_Quit();
+    TTF_Quit();
+    SDL_Quit();
+    if (goldenFailures > 0) return 1;
+    return goldenMissing > 0 ? EXIT_GOLDEN_MISSING : 0;
+}